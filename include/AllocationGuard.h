@@ -0,0 +1,219 @@
+/*
+ * This file is part of EasyLink Library.
+ *
+ * Copyright (c) 2014 FEMTO-ST, ENSMM, UFC, CNRS.
+ *
+ * License: GNU General Public License 3
+ *
+ * Author: Guillaume J. Laurent
+ *
+ */
+
+#ifndef EASYLINK_ALLOCATIONGUARD_H
+#define EASYLINK_ALLOCATIONGUARD_H
+
+/*
+ * Diagnostic mode reporting heap allocations in hot callbacks (outputs,
+ * derivatives, update, zeroCrossings and computeOutputs).
+ *
+ * Compile with -DEASYLINK_NO_MALLOC to report the first allocation of each
+ * callback of each block as a warning and a summary when the block terminates.
+ * Add -DEASYLINK_NO_MALLOC_STRICT to stop the simulation with an error instead.
+ *
+ * Allocations are counted by replacing the global operator new of the MEX file
+ * and, when Eigen is used, by enabling EIGEN_RUNTIME_NO_MALLOC. Allocations
+ * made by MATLAB or other libraries are not counted.
+ */
+#ifdef EASYLINK_NO_MALLOC
+
+#include "Utils.h"
+#include <new>
+#include <map>
+#include <mutex>
+#include <string>
+#include <stdexcept>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#ifdef EIGEN_WORLD_VERSION
+// Eigen was included before EasyLink.h: its allocations cannot be counted
+#define EASYLINK_EIGEN_INCLUDED_FIRST
+#endif
+
+#ifndef EIGEN_RUNTIME_NO_MALLOC
+#define EIGEN_RUNTIME_NO_MALLOC
+#endif
+
+#ifndef eigen_assert
+#define eigen_assert(x) do { if (!(x)) AllocationGuard::eigenAssertionFailed(#x); } while (false)
+#endif
+
+/** AllocationGuard counts the heap allocations made while it is alive. */
+class AllocationGuard {
+public:
+
+    /** Starts counting the allocations of the callback of a block. */
+    AllocationGuard(const char *blockName, const char *callbackName) {
+        this->blockName = blockName;
+        this->callbackName = callbackName;
+        previousCount = count();
+        previousActive = active();
+        active() = true;
+        if (allowEigenMalloc != NULL)
+            allowEigenMalloc(false);
+    }
+
+    /** Stops counting. */
+    ~AllocationGuard() {
+        stop();
+    }
+
+    /** Stops counting and reports the allocations, if any.
+     *
+     * With EASYLINK_NO_MALLOC_STRICT, throws an exception if the callback
+     * allocated. Otherwise, the first offending call of each callback is
+     * reported as a warning. */
+    void check() {
+        stop();
+        long allocations = count() - previousCount;
+        if (allocations == 0)
+            return;
+
+        std::string key = blockName + std::string(":") + callbackName;
+        std::lock_guard<std::mutex> lock(totalsMutex());
+        long &total = totals()[key];
+        std::string message = "EasyLink: block '" + std::string(blockName) + "' made "
+                + toString(allocations) + " heap allocation(s) in " + callbackName + "().";
+#ifdef EASYLINK_NO_MALLOC_STRICT
+        total += allocations;
+        throw std::runtime_error(message);
+#else
+        if (total == 0)
+            warn(message);
+        total += allocations;
+#endif
+    }
+
+    /** Reports the total number of allocations of each callback of a block. */
+    static void report(const char *blockName) {
+        std::string prefix = blockName + std::string(":");
+        std::lock_guard<std::mutex> lock(totalsMutex());
+        std::map<std::string, long>::iterator it = totals().lower_bound(prefix);
+        while (it != totals().end() && it->first.compare(0, prefix.size(), prefix) == 0) {
+            warn("EasyLink: block '" + std::string(blockName) + "' made " + toString(it->second)
+                    + " heap allocation(s) in " + it->first.substr(prefix.size()) + "() during the simulation.");
+            totals().erase(it++);
+        }
+    }
+
+    /** Counts one allocation if a guard is active. */
+    static inline void recordAllocation() {
+        if (active())
+            count()++;
+    }
+
+    /** Handler of Eigen assertions in diagnostic mode. Heap allocations
+     * forbidden by EIGEN_RUNTIME_NO_MALLOC are counted, other failed
+     * assertions throw an exception unless NDEBUG is defined. */
+    static void eigenAssertionFailed(const char *assertion) {
+        if (strstr(assertion, "is_malloc_allowed") != NULL) {
+            count()++;
+            return;
+        }
+#ifndef NDEBUG
+        throw std::runtime_error("Eigen assertion failed: " + std::string(assertion));
+#endif
+    }
+
+    /** Eigen::internal::set_is_malloc_allowed when Eigen is used (set by
+     * sfunDefinitions.h and mexDefinitions.h). */
+    static bool (*allowEigenMalloc)(bool);
+
+private:
+
+    const char *blockName;
+    const char *callbackName;
+    long previousCount;
+    bool previousActive;
+
+    void stop() {
+        if (active() && !previousActive && allowEigenMalloc != NULL)
+            allowEigenMalloc(true);
+        active() = previousActive;
+    }
+
+    static long& count() {
+        static thread_local long value = 0;
+        return value;
+    }
+
+    static bool& active() {
+        static thread_local bool value = false;
+        return value;
+    }
+
+    static std::map<std::string, long>& totals() {
+        static std::map<std::string, long> value;
+        return value;
+    }
+
+    static std::mutex& totalsMutex() {
+        static std::mutex value;
+        return value;
+    }
+
+    static void warn(const std::string &message) {
+#ifdef MATLAB_MEX_FILE
+        mexWarnMsgIdAndTxt("EasyLink:allocation", "%s", message.c_str());
+#else
+        fprintf(stderr, "EasyLink:allocation: %s\n", message.c_str());
+#endif
+    }
+};
+
+void* operator new(std::size_t size) {
+    AllocationGuard::recordAllocation();
+    void *p = malloc(size > 0 ? size : 1);
+    if (p == NULL)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new[](std::size_t size) {
+    AllocationGuard::recordAllocation();
+    void *p = malloc(size > 0 ? size : 1);
+    if (p == NULL)
+        throw std::bad_alloc();
+    return p;
+}
+
+void* operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    AllocationGuard::recordAllocation();
+    return malloc(size > 0 ? size : 1);
+}
+
+void* operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    AllocationGuard::recordAllocation();
+    return malloc(size > 0 ? size : 1);
+}
+
+void operator delete(void *p) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p) noexcept {
+    free(p);
+}
+
+void operator delete(void *p, const std::nothrow_t &) noexcept {
+    free(p);
+}
+
+void operator delete[](void *p, const std::nothrow_t &) noexcept {
+    free(p);
+}
+
+#endif
+
+#endif
@@ -200,7 +200,7 @@ public:
         } else // shared data
         {
             if (nrows != array.nrows || ncols != array.ncols)
-                throw std::runtime_error("Unable to assign " + array.name + " to shared array " + name + ". Array dimensions must agree.");
+                EASYLINK_ERROR_RETURN(std::runtime_error, "Unable to assign " + array.name + " to shared array " + name + ". Array dimensions must agree.", *this);
 
 #ifdef __TEST__
             printf("EasyLink test message: hard copy in assignment \"%s=%s\".\n", name.c_str(), array.name.c_str());
@@ -229,7 +229,7 @@ public:
         } else // shared data
         {
             if (nrows != array.nrows || ncols != array.ncols)
-                throw std::runtime_error("Unable to move assign " + array.name + " to shared array " + name + ". Array dimensions must agree.");
+                EASYLINK_ERROR_RETURN(std::runtime_error, "Unable to move assign " + array.name + " to shared array " + name + ". Array dimensions must agree.", *this);
 
 #ifdef __TEST__
             printf("EasyLink test message: hard copy in assignment \"%s=%s\".\n", name.c_str(), array.name.c_str());
@@ -281,18 +281,20 @@ public:
 
     /** Read/write access to the element i of the array.
      * i can go from 0 to nrows*ncols-1.
-     * Range errors throw an exception. */
+     * Range errors throw an exception (return a zeroed scratch element in the
+     * exception-free profile). */
     _Scalar & operator[](int i) {
         if ((i < 0) || (i >= nrows * ncols))
-            throw std::range_error("Index exceeds array dimensions when accessing to " + name + "[" + toString(i) + "].");
+            EASYLINK_ERROR_RETURN(std::range_error, "Index exceeds array dimensions when accessing to " + name + "[" + toString(i) + "].", getInvalidElement());
         return *(data + i);
     }
 
     /** Read/write access to the element (row,col) of the array.
-        Range errors throw an exception. */
+        Range errors throw an exception (return a zeroed scratch element in the
+        exception-free profile). */
     _Scalar & operator()(int row, int col) {
         if ((row < 0) || (row >= nrows) || (col < 0) || (col >= ncols))
-            throw std::range_error("Index exceeds array dimensions when accessing to " + name + "(" + toString(row) + "," + toString(col) + ").");
+            EASYLINK_ERROR_RETURN(std::range_error, "Index exceeds array dimensions when accessing to " + name + "(" + toString(row) + "," + toString(col) + ").", getInvalidElement());
         return *(data + row + nrows * col);
     }
 
@@ -308,7 +310,7 @@ public:
      * nrows*ncols must equal the number of elements of the array. */
     void reshape(int nrows, int ncols) {
         if (this->nrows * this->ncols != nrows * ncols)
-            throw std::runtime_error("Unable to reshape " + name + ".");
+            EASYLINK_ERROR(std::runtime_error, "Unable to reshape " + name + ".");
 
         this->nrows = nrows;
         this->ncols = ncols;
@@ -406,7 +408,7 @@ public:
      * Arrays must have the same dimensions. */
     void operator+=(const Array<_Scalar> & operand) {
         if (nrows != operand.nrows || ncols != operand.ncols)
-            throw std::runtime_error("Unable to add " + name + " and " + operand.name + ". Array dimensions must agree.");
+            EASYLINK_ERROR(std::runtime_error, "Unable to add " + name + " and " + operand.name + ". Array dimensions must agree.");
 
         int i = nrows*ncols;
         _Scalar* p = data;
@@ -419,7 +421,7 @@ public:
      * Arrays must have the same dimensions. */
     void operator-=(const Array<_Scalar> & operand) {
         if (nrows != operand.nrows || ncols != operand.ncols)
-            throw std::runtime_error("Unable to substract " + name + " and " + operand.name + ". Array dimensions must agree.");
+            EASYLINK_ERROR(std::runtime_error, "Unable to substract " + name + " and " + operand.name + ". Array dimensions must agree.");
 
         int i = nrows*ncols;
         _Scalar* p = data;
@@ -432,7 +434,7 @@ public:
      * Arrays must have the same dimensions. */
     void operator*=(const Array<_Scalar> & operand) {
         if (nrows != operand.nrows || ncols != operand.ncols)
-            throw std::runtime_error("Unable to multiply " + name + " and " + operand.name + ". Array dimensions must agree.");
+            EASYLINK_ERROR(std::runtime_error, "Unable to multiply " + name + " and " + operand.name + ". Array dimensions must agree.");
 
         int i = nrows*ncols;
         _Scalar* p = data;
@@ -445,7 +447,7 @@ public:
      * Arrays must have the same dimensions. */
     void operator/=(const Array<_Scalar> & operand) {
         if (nrows != operand.nrows || ncols != operand.ncols)
-            throw std::runtime_error("Unable to divide " + name + " and " + operand.name + ". Array dimensions must agree.");
+            EASYLINK_ERROR(std::runtime_error, "Unable to divide " + name + " and " + operand.name + ". Array dimensions must agree.");
 
         int i = nrows*ncols;
         _Scalar* p = data;
@@ -589,6 +591,13 @@ protected:
         return result;
     }
 
+    // Element returned by an out-of-range access in the exception-free profile
+    static inline _Scalar & getInvalidElement() {
+        static thread_local _Scalar element;
+        element = _Scalar(0);
+        return element;
+    }
+
 #ifdef __TEST__    
 public:
     static int allocationNumber;
@@ -600,6 +609,58 @@ template<typename _Scalar>
 int Array<_Scalar>::allocationNumber = 0;
 #endif
 
+/** ScalarClassID gives the MATLAB class identifier matching a C++ scalar type.
+ *
+ * ScalarClassID<_Scalar>::value is mxUNKNOWN_CLASS for unsupported types. */
+template<typename _Scalar>
+struct ScalarClassID {
+    static const mxClassID value = mxUNKNOWN_CLASS;
+};
+
+template<> struct ScalarClassID<double> {
+    static const mxClassID value = mxDOUBLE_CLASS;
+};
+
+template<> struct ScalarClassID<float> {
+    static const mxClassID value = mxSINGLE_CLASS;
+};
+
+template<> struct ScalarClassID<signed char> {
+    static const mxClassID value = mxINT8_CLASS;
+};
+
+template<> struct ScalarClassID<unsigned char> {
+    static const mxClassID value = mxUINT8_CLASS;
+};
+
+template<> struct ScalarClassID<short> {
+    static const mxClassID value = mxINT16_CLASS;
+};
+
+template<> struct ScalarClassID<unsigned short> {
+    static const mxClassID value = mxUINT16_CLASS;
+};
+
+template<> struct ScalarClassID<int> {
+    static const mxClassID value = mxINT32_CLASS;
+};
+
+template<> struct ScalarClassID<unsigned int> {
+    static const mxClassID value = mxUINT32_CLASS;
+};
+
+template<> struct ScalarClassID<long long> {
+    static const mxClassID value = mxINT64_CLASS;
+};
+
+template<> struct ScalarClassID<unsigned long long> {
+    static const mxClassID value = mxUINT64_CLASS;
+};
+
+template<> struct ScalarClassID<bool> {
+    static const mxClassID value = mxLOGICAL_CLASS;
+};
+
 /** Double-array addition. */
 template<typename _Scalar>
 Array<_Scalar> operator+(_Scalar x, Array<_Scalar> & operand) {
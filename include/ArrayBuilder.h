@@ -0,0 +1,158 @@
+/*
+ * This file is part of EasyLink Library.
+ *
+ * Copyright (c) 2014 FEMTO-ST, ENSMM, UFC, CNRS.
+ *
+ * License: GNU General Public License 3
+ *
+ * Author: Guillaume J. Laurent
+ *
+ */
+
+#ifndef EASYLINK_ARRAYBUILDER_H
+#define EASYLINK_ARRAYBUILDER_H
+
+#include "Array.h"
+
+/** ArrayBuilder is a growable array used to build outputs whose size is not
+ * known in advance.
+ *
+ * Columns of nrows elements are appended one by one. The memory is allocated
+ * with mxMalloc and doubled each time the capacity is exceeded. When the array
+ * is complete, release returns an mxArray that adopts the memory without any
+ * copy (use BaseFunction::setOutputPort to write it to an output port).
+ */
+template<typename _Scalar>
+class ArrayBuilder {
+public:
+
+    /** Construct an empty builder of arrays with nrows rows.
+     * The capacity is the initial number of columns allocated. */
+    ArrayBuilder(int nrows = 1, int capacity = 16, std::string name = "untitled builder") {
+        if (nrows <= 0)
+            throw std::runtime_error("Unable to build " + name + ". The number of rows must be positive.");
+        this->nrows = nrows;
+        this->ncols = 0;
+        this->capacity = 0;
+        this->data = NULL;
+        this->name = name;
+        reserve(capacity);
+    }
+
+    /** Destructor. Free the memory if it has not been released. */
+    ~ArrayBuilder() {
+        if (data != NULL)
+            mxFree(data);
+    }
+
+    /** Allocates memory for at least ncols columns. */
+    void reserve(int ncols) {
+        if (ncols <= capacity)
+            return;
+        _Scalar *buffer = (_Scalar*) mxRealloc(data, (size_t) ncols * nrows * sizeof (_Scalar));
+        if (buffer == NULL)
+            throw std::runtime_error("Unable to allocate memory for " + name + ".");
+        data = buffer;
+        capacity = ncols;
+    }
+
+    /** Appends a column and returns a pointer to its first element.
+     * The elements of the new column are not initialized. */
+    inline _Scalar* appendColumn() {
+        if (ncols == capacity)
+            reserve(capacity > 0 ? 2 * capacity : 16);
+        return data + (size_t) nrows * (ncols++);
+    }
+
+    /** Appends a column copied from nrows elements. */
+    inline void appendColumn(const _Scalar *column) {
+        memcpy((void*) appendColumn(), (const void*) column, nrows * sizeof (_Scalar));
+    }
+
+    /** Appends a value. Only allowed for builders with a single row. */
+    inline void append(_Scalar x) {
+        if (nrows != 1)
+            throw std::runtime_error("Unable to append a scalar to " + name + ". Use appendColumn.");
+        *appendColumn() = x;
+    }
+
+    /** Removes all the columns. The memory is kept for reuse. */
+    void clear() {
+        ncols = 0;
+    }
+
+    /** Returns the number of rows of the array. */
+    int getNRows() {
+        return nrows;
+    }
+
+    /** Returns the number of columns appended so far. */
+    int getNCols() {
+        return ncols;
+    }
+
+    /** Returns the number of elements appended so far. */
+    int getWidth() {
+        return nrows*ncols;
+    }
+
+    /** Returns the address of the data. The address may change when appending. */
+    _Scalar* getData() {
+        return data;
+    }
+
+    /** Read/write access to the element i of the array.
+     * Range errors throw an exception. */
+    _Scalar & operator[](int i) {
+        if ((i < 0) || (i >= nrows * ncols))
+            throw std::range_error("Index exceeds array dimensions when accessing to " + name + "[" + toString(i) + "].");
+        return data[i];
+    }
+
+    /** Returns an Array sharing the elements appended so far (no data copy).
+     * The Array is invalidated by the next append. */
+    Array<_Scalar> getArray() {
+        return Array<_Scalar>(data, nrows, ncols, name, true);
+    }
+
+    /** Returns a new mxArray that adopts the data (no data copy).
+     *
+     * The memory is shrunk to the exact size of the array using mxRealloc.
+     * The builder is emptied and can be reused. */
+    mxArray* release() {
+        mxArray *mxarray = mxCreateNumericMatrix(0, 0, ScalarClassID<_Scalar>::value, mxREAL);
+        if (mxarray == NULL)
+            throw std::runtime_error("Unable to create the mxArray of " + name + ".");
+
+        if (ncols > 0) {
+            if (ncols < capacity) {
+                _Scalar *buffer = (_Scalar*) mxRealloc(data, (size_t) ncols * nrows * sizeof (_Scalar));
+                if (buffer != NULL)
+                    data = buffer;
+            }
+            mxSetData(mxarray, data);
+            mxSetM(mxarray, nrows);
+            mxSetN(mxarray, ncols);
+        } else {
+            mxFree(data);
+            mxSetM(mxarray, nrows);
+        }
+
+        data = NULL;
+        capacity = 0;
+        ncols = 0;
+        return mxarray;
+    }
+
+private:
+
+    int nrows, ncols, capacity;
+    _Scalar *data;
+    std::string name;
+
+    // The memory is owned by a single builder.
+    ArrayBuilder(const ArrayBuilder<_Scalar> &);
+    ArrayBuilder<_Scalar>& operator=(const ArrayBuilder<_Scalar> &);
+};
+
+#endif
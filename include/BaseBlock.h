@@ -13,37 +13,360 @@
 #define EASYLINK_BASEBLOCK_H
 
 #include "Array.h"
+#include "SimState.h"
+#include "Dual.h"
+#include <type_traits>
+#include <vector>
+#include <deque>
+#include <cstring>
+#include <algorithm>
+#include <new>
+#include <initializer_list>
+
+// Errors of the runtime accessors (port, parameter and DWork numbers, map
+// dimensions), thrown as exceptions caught by the mdl* functions. In the
+// exception-free profile (EASYLINK_EXCEPTION_FREE), the error is reported with
+// setErrorStatus and the accessor returns a safe value (an empty port, zero or
+// a map of a zeroed buffer): the simulation stops when the method returns.
+#ifdef EASYLINK_EXCEPTION_FREE
+#define EASYLINK_RUNTIME_ERROR(message) do { setErrorStatus(std::string(message).c_str()); return; } while (false)
+#define EASYLINK_RUNTIME_ERROR_RETURN(message, value) do { setErrorStatus(std::string(message).c_str()); return value; } while (false)
+#else
+#define EASYLINK_RUNTIME_ERROR(message) throw std::runtime_error(message)
+#define EASYLINK_RUNTIME_ERROR_RETURN(message, value) throw std::runtime_error(message)
+#endif
+
+/** Options of the input and output ports, combined with | in setInputPort
+ * and setOutputPort. */
+enum PortOptions {
+    PORT_DEFAULT = 0,
+    /** The port carries frames: nRows samples of nCols channels per call. */
+    PORT_FRAME = 1,
+    /** The port carries frames or samples depending on the signal connected
+     * (output ports follow the input ports). */
+    PORT_FRAME_INHERITED = 2,
+    /** The dimensions of the port can change during the simulation, up to
+     * the dimensions of the port (variable-size signal). */
+    PORT_VARIABLE_SIZE = 4,
+    /** The input port accepts scattered elements (for instance from a Mux):
+     * Simulink does not copy them to a contiguous buffer. Use getInputView
+     * or gatherInput to read the port. */
+    PORT_NON_CONTIGUOUS = 8,
+    /** The block may overwrite the input port, so that Simulink can reuse
+     * its buffer for an output port (see setInPlacePair). */
+    PORT_OVERWRITABLE = 16,
+    /** Simulink may reuse the buffer of the port for other signals once the
+     * block has been executed. */
+    PORT_REUSABLE = 32,
+    /** The buffer of the port may be local to the generated function 
+     * instead of global. */
+    PORT_LOCAL = 64
+};
+
+/** InputPortView gives access to the elements of an input port, contiguous
+ * or not, without copying them.
+ *
+ * The elements of a non-contiguous port are read through the pointers that
+ * Simulink provides for each element (InputPtrsType). */
+template<typename _Scalar>
+class InputPortView {
+public:
+
+    /** Iterator over the elements of the port, in column-major order. */
+    class Iterator {
+    public:
+
+        Iterator(const InputPortView *view, int index) : view(view), index(index) {
+        }
+
+        inline const _Scalar & operator*() const {
+            return (*view)[index];
+        }
+
+        inline Iterator & operator++() {
+            index++;
+            return *this;
+        }
+
+        inline bool operator!=(const Iterator & other) const {
+            return index != other.index;
+        }
+
+    private:
+        const InputPortView *view;
+        int index;
+    };
+
+    InputPortView(const _Scalar *data, const void * const *pointers, int nRows, int nCols) {
+        this->data = data;
+        this->pointers = pointers;
+        this->nRows = nRows;
+        this->nCols = nCols;
+    }
+
+    inline int getNRows() const {
+        return nRows;
+    }
+
+    inline int getNCols() const {
+        return nCols;
+    }
+
+    inline int getWidth() const {
+        return nRows * nCols;
+    }
+
+    /** Returns true if the elements are contiguous (getData is valid). */
+    inline bool isContiguous() const {
+        return data != NULL;
+    }
+
+    /** Returns the first element of a contiguous port, NULL otherwise. */
+    inline const _Scalar* getData() const {
+        return data;
+    }
+
+    inline const _Scalar & operator[](int index) const {
+        return data != NULL ? data[index] : *((const _Scalar*) pointers[index]);
+    }
+
+    inline const _Scalar & operator()(int row, int col) const {
+        return (*this)[row + col * nRows];
+    }
+
+    inline Iterator begin() const {
+        return Iterator(this, 0);
+    }
+
+    inline Iterator end() const {
+        return Iterator(this, nRows * nCols);
+    }
+
+private:
+    const _Scalar *data;
+    const void * const *pointers;
+    int nRows;
+    int nCols;
+};
 
 /** BaseBlock is the basis class for designing new S-functions.
  *
  * Use the file sfun_offset.cpp as a template to write a new S-function.
  */
 class BaseBlock {
+public:
+
+    /** Data address, dimensions and type of a port.
+     * 
+     * For variable-size ports, nRows, nCols and width are the current 
+     * dimensions and maxNRows and maxNCols the maximum dimensions. */
+    struct PortDescriptor {
+        void *data;
+        int nRows;
+        int nCols;
+        int width;
+        int maxNRows;
+        int maxNCols;
+        DTypeId type;
+        bool frame;
+        bool variableSize;
+        const void * const *pointers; // elements of a non-contiguous input port
+        std::vector<double> staging; // contiguous copy of a non-contiguous input port
+        std::string name;
+    };
+
+    /** Copy of the value of a parameter, converted when the simulation starts
+     * and each time the parameters are tuned. */
+    struct ParameterDescriptor {
+        std::vector<double> storage; // double elements keep the data aligned
+        void *data;
+        size_t size;
+        int nRows;
+        int nCols;
+        int width;
+        mxClassID type;
+        std::string string;
+        std::string name;
+        bool changed;
+    };
+
 protected:
 
-    /** SimStruct data structure allocated for the S-function.
-     * Can be used to call simulink macros. */
-    static SimStruct *simStruct;
+    /** SimStruct data structure of the block instance, set before start is 
+     * called. Can be used to call simulink macros in runtime methods. 
+     * 
+     * Static methods receive the SimStruct as argument instead. */
+    SimStruct *simStruct;
+
+    // Port descriptors resolved once per simulation, so that runtime 
+    // accessors do not call the SimStruct for each access.
+    std::vector<PortDescriptor> inputPorts;
+    std::vector<PortDescriptor> outputPorts;
+
+    // Parameter values converted once, so that runtime accessors do not read
+    // the mxArrays for each access.
+    std::vector<ParameterDescriptor> parameters;
+
+    // Sparsity pattern of the Jacobian (compressed columns), written to 
+    // Simulink at the first call of mdlJacobian.
+    std::vector<int> jacobianRowIndices;
+    std::vector<int> jacobianColumnStarts;
+    bool jacobianPatternWritten;
+
+    // Column coloring of the Jacobian pattern and dual numbers of 
+    // differentiateJacobian, allocated at the first call.
+    JacobianColoring jacobianColoring;
+    std::vector<unsigned char> jacobianWork;
+
+    // Safe values returned by the runtime accessors after an error in the
+    // exception-free profile (see EASYLINK_RUNTIME_ERROR).
+    PortDescriptor invalidPort;
+    ParameterDescriptor invalidParameter;
+    double invalidData[2];
+    std::deque<std::vector<double> > invalidMaps;
+
+    // Returns a map of a zeroed buffer, with the compile-time dimensions of 
+    // the map or the given dimensions.
+    template<typename _Map>
+    _Map getInvalidMap(int nRows, int nCols) {
+        nRows = _Map::RowsAtCompileTime >= 0 ? (int) _Map::RowsAtCompileTime : std::max(nRows, 0);
+        nCols = _Map::ColsAtCompileTime >= 0 ? (int) _Map::ColsAtCompileTime : std::max(nCols, 0);
+        invalidMaps.push_back(std::vector<double>((size_t) nRows * nCols * sizeof (typename _Map::Scalar) / sizeof (double) + 1, 0.0));
+        return _Map((typename _Map::PointerArgType) invalidMaps.back().data(), nRows, nCols);
+    }
 
-private:
-    static int parameterPortsCount;
-    static int inputPortsCount;
-    static int outputPortsCount;
+    // Returns a zeroed buffer of the size of a bus struct.
+    template<typename _Bus>
+    _Bus* getInvalidBus() {
+        invalidMaps.push_back(std::vector<double>(sizeof (_Bus) / sizeof (double) + 1, 0.0));
+        return (_Bus*) invalidMaps.back().data();
+    }
 
 public:
 
-    static inline void setSimStruct(SimStruct *S) {
+    BaseBlock() {
+        simStruct = NULL;
+        jacobianPatternWritten = false;
+        invalidData[0] = invalidData[1] = 0.0;
+        invalidPort.data = invalidData;
+        invalidPort.nRows = invalidPort.nCols = invalidPort.width = 0;
+        invalidPort.maxNRows = invalidPort.maxNCols = 0;
+        invalidPort.type = SS_DOUBLE;
+        invalidPort.frame = false;
+        invalidPort.variableSize = false;
+        invalidPort.pointers = NULL;
+        invalidPort.name = "invalid port";
+        invalidParameter.data = invalidData;
+        invalidParameter.size = 0;
+        invalidParameter.nRows = invalidParameter.nCols = invalidParameter.width = 0;
+        invalidParameter.type = mxDOUBLE_CLASS;
+        invalidParameter.name = "invalid parameter";
+        invalidParameter.changed = false;
+    }
+
+    /** Binds the block instance to its SimStruct and resolves the port 
+     * descriptors and the parameters (called once in mdlStart). */
+    inline void setSimStruct(SimStruct *S) {
         simStruct = S;
+        refreshPortDescriptors();
+        refreshParameters();
+    }
+
+    /** Copies the values of the parameters and flags the parameters whose 
+     * value has changed since the last call (called in mdlStart and in 
+     * mdlProcessParameters).
+     * 
+     * Returns true if at least one parameter has changed. */
+    bool refreshParameters() {
+        bool first = (int) parameters.size() != ssGetSFcnParamsCount(simStruct);
+        if (first)
+            parameters.resize(ssGetSFcnParamsCount(simStruct));
+        bool anyChanged = false;
+        for (int port = 0; port < (int) parameters.size(); port++) {
+            const mxArray *mxarray = ssGetSFcnParam(simStruct, port);
+            ParameterDescriptor &parameter = parameters[port];
+            size_t size = mxGetNumberOfElements(mxarray) * mxGetElementSize(mxarray);
+            parameter.changed = first || parameter.type != mxGetClassID(mxarray)
+                    || parameter.nRows != (int) mxGetM(mxarray) || parameter.nCols != (int) mxGetN(mxarray)
+                    || parameter.size != size || (size > 0 && memcmp(parameter.data, mxGetData(mxarray), size) != 0);
+            if (!parameter.changed)
+                continue;
+            anyChanged = true;
+            parameter.storage.resize((size + sizeof (double) - 1) / sizeof (double));
+            parameter.data = parameter.storage.empty() ? NULL : (void*) &parameter.storage[0];
+            if (size > 0)
+                memcpy(parameter.data, mxGetData(mxarray), size);
+            parameter.size = size;
+            parameter.nRows = (int) mxGetM(mxarray);
+            parameter.nCols = (int) mxGetN(mxarray);
+            parameter.width = parameter.nRows * parameter.nCols;
+            parameter.type = mxGetClassID(mxarray);
+            parameter.name = "parameter " + toString(port);
+            if (mxIsChar(mxarray)) {
+                std::vector<char> buffer(mxGetNumberOfElements(mxarray) + 1);
+                mxGetString(mxarray, &buffer[0], (mwSize) buffer.size());
+                parameter.string = &buffer[0];
+            } else {
+                parameter.string.clear();
+            }
+        }
+        return anyChanged;
+    }
+
+    /** Resolves again the data address and the dimensions of all the ports.
+     * 
+     * Port descriptors are resolved when the simulation starts. This method 
+     * must be called if Simulink may have changed the data address or the
+     * dimensions of a port since then. */
+    void refreshPortDescriptors() {
+        inputPorts.resize(ssGetNumInputPorts(simStruct));
+        for (int port = 0; port < (int) inputPorts.size(); port++) {
+            PortDescriptor &input = inputPorts[port];
+            if (ssGetInputPortRequiredContiguous(simStruct, port)) {
+                input.data = (void*) ssGetInputPortSignal(simStruct, port);
+                input.pointers = NULL;
+            } else {
+                input.data = NULL;
+                input.pointers = (const void * const *) ssGetInputPortSignalPtrs(simStruct, port);
+            }
+            input.nRows = ssGetInputPortDimensionSize(simStruct, port, 0);
+            input.nCols = ssGetInputPortNumDimensions(simStruct, port) > 1 ? ssGetInputPortDimensionSize(simStruct, port, 1) : 1;
+            input.width = ssGetInputPortWidth(simStruct, port);
+            input.type = ssGetInputPortDataType(simStruct, port);
+            input.frame = ssGetInputPortFrameData(simStruct, port) == FRAME_YES;
+            input.variableSize = ssGetInputPortDimensionsMode(simStruct, port) == VARIABLE_DIMS_MODE;
+            input.maxNRows = input.nRows;
+            input.maxNCols = input.nCols;
+            if (input.pointers != NULL) {
+                size_t size = (size_t) input.width * ssGetDataTypeSize(simStruct, input.type);
+                input.staging.resize((size + sizeof (double) - 1) / sizeof (double));
+            }
+            input.name = "input port " + toString(port);
+        }
+        outputPorts.resize(ssGetNumOutputPorts(simStruct));
+        for (int port = 0; port < (int) outputPorts.size(); port++) {
+            PortDescriptor &output = outputPorts[port];
+            output.data = ssGetOutputPortSignal(simStruct, port);
+            output.pointers = NULL;
+            output.nRows = ssGetOutputPortDimensionSize(simStruct, port, 0);
+            output.nCols = ssGetOutputPortNumDimensions(simStruct, port) > 1 ? ssGetOutputPortDimensionSize(simStruct, port, 1) : 1;
+            output.width = ssGetOutputPortWidth(simStruct, port);
+            output.type = ssGetOutputPortDataType(simStruct, port);
+            output.frame = ssGetOutputPortFrameData(simStruct, port) == FRAME_YES;
+            output.variableSize = ssGetOutputPortDimensionsMode(simStruct, port) == VARIABLE_DIMS_MODE;
+            output.maxNRows = output.nRows;
+            output.maxNCols = output.nCols;
+            output.name = "output port " + toString(port);
+        }
     }
 
     /**
      * This method checks the number of parameters.
      */
-    static void assertParameterPortsCount(int portsCount) {
-        ssSetNumSFcnParams(simStruct, portsCount);
-        if (ssGetSFcnParamsCount(simStruct) != portsCount)
+    static void assertParameterPortsCount(SimStruct *S, int portsCount) {
+        ssSetNumSFcnParams(S, portsCount);
+        if (ssGetSFcnParamsCount(S) != portsCount)
             throw std::runtime_error(toString(portsCount) + " parameters are expected.");
-        parameterPortsCount = portsCount;
     }
 
     /**
@@ -54,12 +377,12 @@ public:
      * 
      * Use -1 to specify dynamically dimensioned parameter arrays.
      */
-    static void assertParameterPort(int port, bool tunable, int nRows, int nCols, mxClassID type = mxDOUBLE_CLASS, mxComplexity complexFlag = mxREAL) {
+    static void assertParameterPort(SimStruct *S, int port, bool tunable, int nRows, int nCols, mxClassID type = mxDOUBLE_CLASS, mxComplexity complexFlag = mxREAL) {
         if (!tunable) {
-            ssSetSFcnParamNotTunable(simStruct, port);
+            ssSetSFcnParamNotTunable(S, port);
         }
 
-        const mxArray* mxarray = ssGetSFcnParam(simStruct, port);
+        const mxArray* mxarray = ssGetSFcnParam(S, port);
         if (mxIsEmpty(mxarray)) {
             throw std::runtime_error("Parameter port " + toString(port) + " is empty.");
         }
@@ -94,17 +417,16 @@ public:
      * 
      * For more information, see: https://fr.mathworks.com/help/simulink/sfg/mdlcheckparameters.html
      */
-    static void checkParametersSizes() {
-        assertParameterPortsCount(0);
+    static void checkParametersSizes(SimStruct *S) {
+        assertParameterPortsCount(S, 0);
     }
 
     /**
      * This method sets the number of input ports.
      */
-    static void setInputPortsCount(int portsCount) {
-        if (!ssSetNumInputPorts(simStruct, portsCount))
+    static void setInputPortsCount(SimStruct *S, int portsCount) {
+        if (!ssSetNumInputPorts(S, portsCount))
             throw std::runtime_error("Unable to set input port count to " + toString(portsCount) + ".");
-        inputPortsCount = portsCount;
     }
 
     /**
@@ -112,18 +434,36 @@ public:
      * port.
      * 
      * Use -1 to specify dynamically dimensioned intput arrays.
+     * 
+     * Options are a combination of PortOptions. A frame port has nRows 
+     * samples (frame size) and nCols channels. The dimensions of a 
+     * variable-size port are its maximum dimensions.
      */
-    static void setInputPort(int port, int nRows, int nCols, DTypeId type = SS_DOUBLE, bool directFeedThrough = true) {
-        ssSetInputPortDataType(simStruct, port, type);
+    static void setInputPort(SimStruct *S, int port, int nRows, int nCols, DTypeId type = SS_DOUBLE, bool directFeedThrough = true, int options = PORT_DEFAULT) {
+        ssSetInputPortDataType(S, port, type);
         if (nCols == 1) {
-            ssSetInputPortWidth(simStruct, port, nRows);
+            ssSetInputPortWidth(S, port, nRows);
         } else {
-            ssSetInputPortMatrixDimensions(simStruct, port, nRows, nCols);
+            ssSetInputPortMatrixDimensions(S, port, nRows, nCols);
         }
-        ssSetInputPortDirectFeedThrough(simStruct, port, directFeedThrough);
-        ssSetInputPortRequiredContiguous(simStruct, port, 1);
+        ssSetInputPortDirectFeedThrough(S, port, directFeedThrough);
+        ssSetInputPortRequiredContiguous(S, port, (options & PORT_NON_CONTIGUOUS) ? 0 : 1);
         if (nRows < 0 || nCols < 0) {
-            ssSetInputPortDimensionInfo(simStruct, port, DYNAMIC_DIMENSION);
+            ssSetInputPortDimensionInfo(S, port, DYNAMIC_DIMENSION);
+        }
+        if (options & PORT_FRAME) {
+            ssSetInputPortFrameData(S, port, FRAME_YES);
+        } else if (options & PORT_FRAME_INHERITED) {
+            ssSetInputPortFrameData(S, port, FRAME_INHERITED);
+        }
+        if (options & PORT_VARIABLE_SIZE) {
+            ssSetInputPortDimensionsMode(S, port, VARIABLE_DIMS_MODE);
+        }
+        if (options & PORT_OVERWRITABLE) {
+            ssSetInputPortOverWritable(S, port, 1);
+        }
+        if (options & (PORT_REUSABLE | PORT_LOCAL)) {
+            ssSetInputPortOptimOpts(S, port, getPortOptimOpts(options));
         }
     }
 
@@ -142,17 +482,16 @@ public:
      * Use -1 to specify dynamically dimensioned input signals.
      *
      * For more information, see: http://www.mathworks.fr/help/simulink/sfg/mdlinitializesizes.html */
-    static void initializeInputPortSizes() {
-        setInputPortsCount(0);
+    static void initializeInputPortSizes(SimStruct *S) {
+        setInputPortsCount(S, 0);
     }
 
     /**
      * This method sets the number of output ports.
      */
-    static void setOutputPortsCount(int portsCount) {
-        if (!ssSetNumOutputPorts(simStruct, portsCount))
+    static void setOutputPortsCount(SimStruct *S, int portsCount) {
+        if (!ssSetNumOutputPorts(S, portsCount))
             throw std::runtime_error("Unable to set output port count to " + toString(portsCount) + ".");
-        outputPortsCount = portsCount;
     }
 
     /**
@@ -160,17 +499,127 @@ public:
      * port.
      * 
      * Use -1 to specify dynamically dimensioned intput arrays.
+     * 
+     * Options are a combination of PortOptions. Frame output ports with 
+     * dynamic dimensions get the frame size and the channel count of the 
+     * first frame input port. The dimensions of a variable-size port are its
+     * maximum dimensions: the current dimensions are set in outputs using 
+     * setOutputCurrentSizes.
      */
-    static void setOutputPort(int port, int nRows, int nCols, DTypeId type = SS_DOUBLE) {
-        ssSetOutputPortDataType(simStruct, port, type);
+    static void setOutputPort(SimStruct *S, int port, int nRows, int nCols, DTypeId type = SS_DOUBLE, int options = PORT_DEFAULT) {
+        ssSetOutputPortDataType(S, port, type);
         if (nCols == 1) {
-            ssSetOutputPortWidth(simStruct, port, nRows);
+            ssSetOutputPortWidth(S, port, nRows);
         } else {
-            ssSetOutputPortMatrixDimensions(simStruct, port, nRows, nCols);
+            ssSetOutputPortMatrixDimensions(S, port, nRows, nCols);
         }
         if (nRows < 0 || nCols < 0) {
-            ssSetOutputPortDimensionInfo(simStruct, port, DYNAMIC_DIMENSION);
+            ssSetOutputPortDimensionInfo(S, port, DYNAMIC_DIMENSION);
+        }
+        if (options & PORT_FRAME) {
+            ssSetOutputPortFrameData(S, port, FRAME_YES);
+        } else if (options & PORT_FRAME_INHERITED) {
+            ssSetOutputPortFrameData(S, port, FRAME_INHERITED);
+        }
+        if (options & PORT_VARIABLE_SIZE) {
+            ssSetOutputPortDimensionsMode(S, port, VARIABLE_DIMS_MODE);
+        }
+        if (options & (PORT_REUSABLE | PORT_LOCAL)) {
+            ssSetOutputPortOptimOpts(S, port, getPortOptimOpts(options));
+        }
+    }
+
+    /**
+     * Returns the Simulink buffer optimization of a combination of 
+     * PortOptions.
+     */
+    static int getPortOptimOpts(int options) {
+        if (options & PORT_REUSABLE)
+            return (options & PORT_LOCAL) ? SS_REUSABLE_AND_LOCAL : SS_REUSABLE_AND_GLOBAL;
+        else
+            return (options & PORT_LOCAL) ? SS_NOT_REUSABLE_AND_LOCAL : SS_NOT_REUSABLE_AND_GLOBAL;
+    }
+
+    /**
+     * This method declares that an output port may use the buffer of an 
+     * input port (in-place computation). Both ports must have the same 
+     * dimensions and type.
+     * 
+     * The block must then compute the output element by element from the 
+     * same element of the input, for instance using getInPlaceArray.
+     */
+    static void setInPlacePair(SimStruct *S, int inputPort, int outputPort) {
+        if (inputPort < 0 || inputPort >= ssGetNumInputPorts(S))
+            throw std::runtime_error("Input port number " + toString(inputPort) + " does not exist.");
+        if (outputPort < 0 || outputPort >= ssGetNumOutputPorts(S))
+            throw std::runtime_error("Output port number " + toString(outputPort) + " does not exist.");
+        ssSetInputPortOverWritable(S, inputPort, 1);
+        ssSetInputPortBufferDstPort(S, inputPort, outputPort);
+    }
+
+    /**
+     * This method sets an input port carrying a bus, defined by a 
+     * Simulink.Bus object of the MATLAB workspace.
+     * 
+     * The bus is passed as a C struct: use getInputBus to access it and 
+     * assertInputBusLayout to check the layout of the C++ struct.
+     */
+    static void setInputBusPort(SimStruct *S, int port, const char *busName, bool directFeedThrough = true) {
+#if defined(MATLAB_MEX_FILE)
+        if (ssGetSimMode(S) != SS_SIMMODE_SIZES_CALL_ONLY) {
+            DTypeId type = INVALID_DTYPE_ID;
+            ssRegisterTypeFromNamedObject(S, (char*) busName, &type);
+            if (type == INVALID_DTYPE_ID)
+                throw std::runtime_error("Unable to register the bus object " + std::string(busName) + " of input port " + toString(port) + ".");
+            ssSetInputPortDataType(S, port, type);
+        }
+#endif
+        ssSetInputPortWidth(S, port, 1);
+        ssSetInputPortDirectFeedThrough(S, port, directFeedThrough);
+        ssSetInputPortRequiredContiguous(S, port, 1);
+        ssSetBusInputAsStruct(S, port, 1);
+        ssSetInputPortBusMode(S, port, SL_BUS_MODE);
+    }
+
+    /**
+     * This method sets an output port carrying a bus, defined by a 
+     * Simulink.Bus object of the MATLAB workspace.
+     * 
+     * The name must be a string literal (Simulink keeps the pointer).
+     */
+    static void setOutputBusPort(SimStruct *S, int port, const char *busName) {
+#if defined(MATLAB_MEX_FILE)
+        if (ssGetSimMode(S) != SS_SIMMODE_SIZES_CALL_ONLY) {
+            DTypeId type = INVALID_DTYPE_ID;
+            ssRegisterTypeFromNamedObject(S, (char*) busName, &type);
+            if (type == INVALID_DTYPE_ID)
+                throw std::runtime_error("Unable to register the bus object " + std::string(busName) + " of output port " + toString(port) + ".");
+            ssSetOutputPortDataType(S, port, type);
         }
+#endif
+        ssSetOutputPortWidth(S, port, 1);
+        ssSetBusOutputObjectName(S, port, (void*) busName);
+        ssSetBusOutputAsStruct(S, port, 1);
+        ssSetOutputPortBusMode(S, port, SL_BUS_MODE);
+    }
+
+    /**
+     * This method checks that the layout of a C++ struct matches a bus data
+     * type: same size and, if offsets are given, same number of elements and
+     * same element offsets (use offsetof).
+     */
+    template<typename _Bus>
+    static void assertBusLayout(SimStruct *S, DTypeId type, std::initializer_list<size_t> offsets, const std::string & name) {
+        if ((size_t) ssGetDataTypeSize(S, type) != sizeof (_Bus))
+            throw std::runtime_error("The bus of " + name + " has " + toString(ssGetDataTypeSize(S, type)) + " bytes but the struct has " + toString(sizeof (_Bus)) + " bytes.");
+        if (offsets.size() == 0)
+            return;
+        if ((int) offsets.size() != ssGetNumBusElements(S, type))
+            throw std::runtime_error("The bus of " + name + " has " + toString(ssGetNumBusElements(S, type)) + " elements but " + toString(offsets.size()) + " offsets are given.");
+        int element = 0;
+        for (std::initializer_list<size_t>::const_iterator offset = offsets.begin(); offset != offsets.end(); ++offset, element++)
+            if ((size_t) ssGetBusElementOffset(S, type, element) != *offset)
+                throw std::runtime_error("The element " + toString(element) + " of the bus of " + name + " is not at the same offset in the struct.");
     }
 
     /** \ingroup initialization
@@ -186,24 +635,59 @@ public:
      * Use -1 to specify dynamically dimensioned output signals.
      *
      * For more information, see: http://www.mathworks.fr/help/simulink/sfg/mdlinitializesizes.html */
-    static void initializeOutputPortSizes() {
-        setOutputPortsCount(0);
+    static void initializeOutputPortSizes(SimStruct *S) {
+        setOutputPortsCount(S, 0);
     }
 
     /** \ingroup initialization
      * 
      * Sets the number of continuous states.
      */
-    static inline void setContinuousStatesWidth(int num) {
-        ssSetNumContStates(simStruct, num);
+    static inline void setContinuousStatesWidth(SimStruct *S, int num) {
+        ssSetNumContStates(S, num);
     }
 
     /** \ingroup initialization
      * 
      * Sets the number of discrete states.
      */
-    static inline void setDiscreteStatesWidth(int num) {
-        ssSetNumDiscStates(simStruct, num);
+    static inline void setDiscreteStatesWidth(SimStruct *S, int num) {
+        ssSetNumDiscStates(S, num);
+    }
+
+    /**
+     * Sets the number of nonsampled zero-crossing signals of the block (see 
+     * zeroCrossings).
+     * 
+     * Variable-step solvers locate the instants where these signals cross
+     * zero and take a major step there, instead of reducing the step size 
+     * around the discontinuity.
+     */
+    static inline void setZeroCrossingsCount(SimStruct *S, int count) {
+        ssSetNumNonsampledZCs(S, count);
+    }
+
+    /**
+     * Sets the number of modes of the block (see updateModes).
+     * 
+     * Modes are integers selecting the continuous piece of a discontinuous 
+     * block (e.g. saturated or linear). They only change in major time steps
+     * so that the outputs remain continuous during the minor steps of the 
+     * solver.
+     */
+    static inline void setModesCount(SimStruct *S, int count) {
+        ssSetNumModes(S, count);
+    }
+
+    /**
+     * Declares that the block computes the Jacobian of its continuous states
+     * and outputs (see jacobian), with at most nzMax nonzero elements.
+     * 
+     * Stiff solvers (ode15s, ode23t...) then use the Jacobian of the block 
+     * instead of finite differences.
+     */
+    static inline void setJacobianNzMax(SimStruct *S, int nzMax) {
+        ssSetJacobianNzMax(S, nzMax);
     }
 
     /** \ingroup initialization
@@ -215,9 +699,9 @@ public:
      * The default method specifies zero continuous states and zero discrete states.
      *
      * For more information, see: http://www.mathworks.fr/fr/help/simulink/sfg/mdlinitializesizes.html */
-    static void initializeStatePortSizes() {
-        setContinuousStatesWidth(0);
-        setDiscreteStatesWidth(0);
+    static void initializeStatePortSizes(SimStruct *S) {
+        setContinuousStatesWidth(S, 0);
+        setDiscreteStatesWidth(S, 0);
     }
 
     /** \ingroup initialization
@@ -228,10 +712,107 @@ public:
      * which the block operates.
      *
      * The default method specifies is a smaple time value of 1.
+     * 
+     * A multi-rate block sets several sample times using setSampleTimesCount
+     * and implements outputsForRate and updateForRate.
      *
      * For more information, see: http://www.mathworks.fr/help/simulink/sfg/mdlinitializesizes.html */
-    static void initializeNumberSampleTimes() {
-        ssSetNumSampleTimes(simStruct, 1);
+    static void initializeNumberSampleTimes(SimStruct *S) {
+        ssSetNumSampleTimes(S, 1);
+    }
+
+    /**
+     * This method sets the number of sample times of the block.
+     */
+    static void setSampleTimesCount(SimStruct *S, int count) {
+        if (count < 1)
+            throw std::runtime_error("Unable to set sample time count to " + toString(count) + ".");
+        ssSetNumSampleTimes(S, count);
+    }
+
+    /**
+     * This method declares port-based sample times (call it in 
+     * initializeNumberSampleTimes): each input port inherits the sample time
+     * of its signal and the outputs take the sample time of the inputs (see 
+     * setInputPortSampleTime). initializeSampleTimes is then not called.
+     * 
+     * If allowConstant is true, the ports may have a constant sample time 
+     * (Inf): when all the inputs are constant, outputs is called once at 
+     * initialization and Simulink folds the block out of the simulation loop.
+     * The parameters of such a block must not be tunable. A block without 
+     * input is constant if allowConstant is true and otherwise inherits the 
+     * sample time of the blocks it drives (see setOutputPortSampleTime).
+     */
+    static void setPortBasedSampleTimes(SimStruct *S, bool allowConstant = true) {
+        ssSetNumSampleTimes(S, PORT_BASED_SAMPLE_TIMES);
+        for (int port = 0; port < ssGetNumInputPorts(S); port++) {
+            ssSetInputPortSampleTime(S, port, INHERITED_SAMPLE_TIME);
+            ssSetInputPortOffsetTime(S, port, 0.0);
+        }
+        for (int port = 0; port < ssGetNumOutputPorts(S); port++) {
+            ssSetOutputPortSampleTime(S, port, INHERITED_SAMPLE_TIME);
+            ssSetOutputPortOffsetTime(S, port, 0.0);
+        }
+        if (allowConstant)
+            ssSetOptions(S, ssGetOptions(S) | SS_OPTION_ALLOW_CONSTANT_PORT_SAMPLE_TIME);
+        if (ssGetNumInputPorts(S) == 0)
+            propagatePortSampleTimes(S);
+    }
+
+    /** \ingroup initialization
+     * 
+     * This static method is called with the sample time of an input port, 
+     * for blocks with port-based sample times (see setPortBasedSampleTimes).
+     * 
+     * The default method sets the sample time of the port and propagates the
+     * sample times of the inputs to the outputs.
+     *
+     * For more information, see: http://www.mathworks.fr/help/simulink/sfg/mdlsetinputportsampletime.html */
+    static void setInputPortSampleTime(SimStruct *S, int port, double sampleTime, double offsetTime) {
+        ssSetInputPortSampleTime(S, port, sampleTime);
+        ssSetInputPortOffsetTime(S, port, offsetTime);
+        propagatePortSampleTimes(S);
+    }
+
+    /** \ingroup initialization
+     * 
+     * This static method is called with the sample time of an output port, 
+     * for blocks with port-based sample times, when the sample time is 
+     * propagated backward from the blocks connected to the output.
+     *
+     * For more information, see: http://www.mathworks.fr/help/simulink/sfg/mdlsetoutputportsampletime.html */
+    static void setOutputPortSampleTime(SimStruct *S, int port, double sampleTime, double offsetTime) {
+        ssSetOutputPortSampleTime(S, port, sampleTime);
+        ssSetOutputPortOffsetTime(S, port, offsetTime);
+    }
+
+    /**
+     * This method sets the sample time of the output ports still inherited to
+     * the fastest sample time of the inputs, or to a constant sample time if
+     * all the inputs are constant. It does nothing while the sample time of 
+     * an input is unknown.
+     *
+     * The outputs of a block without input are constant if the block allows
+     * constant sample times, and are left inherited otherwise.
+     */
+    static void propagatePortSampleTimes(SimStruct *S) {
+        if (ssGetNumInputPorts(S) == 0 && !(ssGetOptions(S) & SS_OPTION_ALLOW_CONSTANT_PORT_SAMPLE_TIME))
+            return;
+        double constant = mxGetInf();
+        double sampleTime = constant;
+        double offsetTime = 0.0;
+        for (int port = 0; port < ssGetNumInputPorts(S); port++) {
+            double inputSampleTime = ssGetInputPortSampleTime(S, port);
+            if (inputSampleTime == INHERITED_SAMPLE_TIME)
+                return;
+            if (inputSampleTime != constant && (sampleTime == constant || inputSampleTime < sampleTime)) {
+                sampleTime = inputSampleTime;
+                offsetTime = ssGetInputPortOffsetTime(S, port);
+            }
+        }
+        for (int port = 0; port < ssGetNumOutputPorts(S); port++)
+            if (ssGetOutputPortSampleTime(S, port) == INHERITED_SAMPLE_TIME)
+                setOutputPortSampleTime(S, port, sampleTime, offsetTime);
     }
 
     /** \ingroup initialization
@@ -239,16 +820,30 @@ public:
      * This is the sixth and last static method called before the simulation starts.
      * 
      * This method specifies the simulation options that this block implements,
-     * using ssSetOptions.
+     * using ssSetOptions, and may declare the block thread-safe using 
+     * setRuntimeThreadSafe.
      *
      * For more information, see: http://www.mathworks.fr/help/simulink/sfg/mdlinitializesizes.html */
-    static void initializeOptions() {
+    static void initializeOptions(SimStruct *S) {
+    }
+
+    /** \ingroup initialization
+     * 
+     * Declares that the runtime methods of the block can be executed 
+     * concurrently with other blocks (multithreaded simulation).
+     * 
+     * A block is thread-safe if its runtime methods only access the block 
+     * instance, its ports, parameters and states, and no global or static 
+     * variable.
+     */
+    static inline void setRuntimeThreadSafe(SimStruct *S, bool threadSafe = true) {
+        ssSetRuntimeThreadSafetyCompliance(S, threadSafe ? RUNTIME_THREAD_SAFETY_COMPLIANCE_TRUE : RUNTIME_THREAD_SAFETY_COMPLIANCE_FALSE);
     }
 
     /** 
      * This method sets the final dimensions of an input port.
      */
-    static void setInputPortFinalSizes(int port, int nRows, int nCols) {
+    static void setInputPortFinalSizes(SimStruct *S, int port, int nRows, int nCols) {
         if (nRows < 0 || nCols < 0) {
             throw std::runtime_error("Unable to set final dimensions of input port " + toString(port) + ".");
         }
@@ -259,7 +854,7 @@ public:
         dimsInfo.numDims = 2;
         dimsInfo.dims = dims;
         dimsInfo.width = nRows*nCols;
-        ssSetInputPortDimensionInfo(simStruct, 0, &dimsInfo);
+        ssSetInputPortDimensionInfo(S, port, &dimsInfo);
     }
 
     /** \ingroup initialization
@@ -270,13 +865,55 @@ public:
      * throw an exception.
      *
      * For more information, see: http://www.mathworks.fr/help/simulink/sfg/mdlsetinputportdimensioninfo.html */
-    static void checkInputPortFinalSizes(int port, int nRows, int nCols) {
+    static void checkInputPortFinalSizes(SimStruct *S, int port, int nRows, int nCols) {
+    }
+
+    /**
+     * This method checks the frame data proposed for an input port: only a 
+     * port declared with PORT_FRAME_INHERITED accepts both frame-based and 
+     * sample-based signals.
+     */
+    static void checkInputPortFrameData(SimStruct *S, int port, Frame_T frameData) {
+        Frame_T declared = ssGetInputPortFrameData(S, port);
+        if (declared != FRAME_INHERITED && declared != frameData)
+            throw std::runtime_error("Input port " + toString(port) + " does not accept "
+                + (frameData == FRAME_YES ? "frame-based" : "sample-based") + " signals.");
+    }
+
+    /**
+     * This method sets the frame data of the output ports declared with 
+     * PORT_FRAME_INHERITED, once the frame data of every input port is known
+     * (called when the frame data of an input port is set). The outputs are
+     * frame-based if any input is frame-based.
+     */
+    static void setInheritedOutputFrameData(SimStruct *S) {
+        Frame_T frameData = FRAME_NO;
+        for (int port = 0; port < ssGetNumInputPorts(S); port++) {
+            if (ssGetInputPortFrameData(S, port) == FRAME_INHERITED)
+                return;
+            if (ssGetInputPortFrameData(S, port) == FRAME_YES)
+                frameData = FRAME_YES;
+        }
+        for (int port = 0; port < ssGetNumOutputPorts(S); port++)
+            if (ssGetOutputPortFrameData(S, port) == FRAME_INHERITED)
+                ssSetOutputPortFrameData(S, port, frameData);
+    }
+
+    /**
+     * This method sets the dimensions of the frame output ports that are 
+     * still dynamically dimensioned to the frame size and the channel count
+     * of a frame input port.
+     */
+    static void setFrameOutputPortSizes(SimStruct *S, int nRows, int nCols) {
+        for (int port = 0; port < ssGetNumOutputPorts(S); port++)
+            if (ssGetOutputPortFrameData(S, port) != FRAME_NO && ssGetOutputPortWidth(S, port) == DYNAMICALLY_SIZED)
+                setOutputPortFinalSizes(S, port, nRows, nCols);
     }
 
     /** 
      * This method sets the final dimensions of an output port.
      */
-    static void setOutputPortFinalSizes(int port, int nRows, int nCols) {
+    static void setOutputPortFinalSizes(SimStruct *S, int port, int nRows, int nCols) {
         if (nRows < 0 || nCols < 0) {
             throw std::runtime_error("Unable to set final dimensions of output port " + toString(port) + ".");
         }
@@ -287,7 +924,7 @@ public:
         dimsInfo.numDims = 2;
         dimsInfo.dims = dims;
         dimsInfo.width = nRows*nCols;
-        ssSetOutputPortDimensionInfo(simStruct, 0, &dimsInfo);
+        ssSetOutputPortDimensionInfo(S, port, &dimsInfo);
     }
 
     /** \ingroup initialization
@@ -298,7 +935,7 @@ public:
      * throw an exception.
      *
      * For more information, see: http://www.mathworks.fr/help/simulink/sfg/mdlsetoutputportdimensioninfo.html */
-    static void checkOutputPortFinalSizes(int port, int nRows, int nCols) {
+    static void checkOutputPortFinalSizes(SimStruct *S, int port, int nRows, int nCols) {
     }
 
     /** \ingroup initialization
@@ -309,10 +946,145 @@ public:
      * The default values are INHERITED_SAMPLE_TIME and FIXED_IN_MINOR_STEP_OFFSET
      *
      * For more information, see: http://www.mathworks.fr/help/simulink/sfg/mdlinitializesampletimes.html */
-    static void initializeSampleTimes() {
-        ssSetSampleTime(simStruct, 0, INHERITED_SAMPLE_TIME);
-        ssSetOffsetTime(simStruct, 0, 0.0);
-        ssSetModelReferenceSampleTimeDefaultInheritance(simStruct);
+    static void initializeSampleTimes(SimStruct *S) {
+        ssSetSampleTime(S, 0, INHERITED_SAMPLE_TIME);
+        ssSetOffsetTime(S, 0, 0.0);
+        ssSetModelReferenceSampleTimeDefaultInheritance(S);
+    }
+
+    /**
+     * This method sets the period and the offset of a sample time.
+     * 
+     * Sample times must be set from the fastest (index 0) to the slowest.
+     */
+    static void setSampleTime(SimStruct *S, int index, double period, double offset = 0.0) {
+        if (index < 0 || index >= ssGetNumSampleTimes(S))
+            throw std::runtime_error("Sample time number " + toString(index) + " does not exist.");
+        ssSetSampleTime(S, index, period);
+        ssSetOffsetTime(S, index, offset);
+    }
+
+    /**
+     * This method sets a variable sample time: the block runs at the times
+     * returned by timeOfNextHit, which the block must implement.
+     */
+    static void setVariableSampleTime(SimStruct *S, int index = 0) {
+        setSampleTime(S, index, VARIABLE_SAMPLE_TIME, 0.0);
+    }
+
+    /** \ingroup workPort
+     * 
+     * Sets the number of data work vectors (DWork).
+     */
+    static inline void setDWorksCount(SimStruct *S, int count) {
+        if (!ssSetNumDWork(S, count))
+            throw std::runtime_error("Unable to set DWork count to " + toString(count) + ".");
+    }
+
+    /** \ingroup workPort
+     * 
+     * Sets the width, the type and the name of a data work vector (DWork).
+     * 
+     * DWorks are allocated and owned by Simulink. Set state to true if the 
+     * DWork holds a discrete state of the block: it is then logged, saved in 
+     * operating points and declared as a state in generated code. 
+     * 
+     * The name must be a string literal (Simulink keeps the pointer).
+     */
+    static void setDWork(SimStruct *S, int index, int width, DTypeId type = SS_DOUBLE, const char *name = NULL, bool state = false) {
+        ssSetDWorkWidth(S, index, width);
+        ssSetDWorkDataType(S, index, type);
+        if (name != NULL)
+            ssSetDWorkName(S, index, name);
+        ssSetDWorkUsageType(S, index, state ? SS_DWORK_USED_AS_DSTATE : SS_DWORK_USED_AS_DWORK);
+    }
+
+    /**
+     * Declares that the current dimensions of the variable-size output ports
+     * are computed in outputs (called in mdlSetWorkWidths).
+     */
+    static void initializeVariableSizeOutputs(SimStruct *S) {
+        for (int port = 0; port < ssGetNumOutputPorts(S); port++) {
+            if (ssGetOutputPortDimensionsMode(S, port) == VARIABLE_DIMS_MODE) {
+                ssSetSignalSizesComputeType(S, SS_VARIABLE_SIZE_FROM_INPUT_VALUE_AND_SIZE);
+                return;
+            }
+        }
+    }
+
+    /**
+     * Returns the Simulink data type of a parameter class, or INVALID_DTYPE_ID
+     * if the class cannot be a run-time parameter.
+     */
+    static DTypeId getParameterDataTypeId(const mxArray *mxarray) {
+        if (mxIsSparse(mxarray) || mxIsComplex(mxarray))
+            return INVALID_DTYPE_ID;
+        switch (mxGetClassID(mxarray)) {
+            case mxDOUBLE_CLASS: return SS_DOUBLE;
+            case mxSINGLE_CLASS: return SS_SINGLE;
+            case mxINT8_CLASS: return SS_INT8;
+            case mxUINT8_CLASS: return SS_UINT8;
+            case mxINT16_CLASS: return SS_INT16;
+            case mxUINT16_CLASS: return SS_UINT16;
+            case mxINT32_CLASS: return SS_INT32;
+            case mxUINT32_CLASS: return SS_UINT32;
+            case mxLOGICAL_CLASS: return SS_BOOLEAN;
+            default: return INVALID_DTYPE_ID;
+        }
+    }
+
+    /**
+     * Registers the numeric parameters as run-time parameters (called in
+     * mdlSetWorkWidths), so that generated code and tuning use typed data.
+     */
+    static void registerRunTimeParameters(SimStruct *S) {
+        // Simulink keeps the name pointers: names are stored once for all
+        static std::deque<std::string> names;
+        int count = 0;
+        for (int port = 0; port < ssGetSFcnParamsCount(S); port++)
+            if (getParameterDataTypeId(ssGetSFcnParam(S, port)) != INVALID_DTYPE_ID)
+                count++;
+        ssSetNumRunTimeParams(S, count);
+        int index = 0;
+        for (int port = 0; port < ssGetSFcnParamsCount(S); port++) {
+            DTypeId type = getParameterDataTypeId(ssGetSFcnParam(S, port));
+            if (type == INVALID_DTYPE_ID)
+                continue;
+            while ((int) names.size() <= port)
+                names.push_back("P" + toString((int) names.size() + 1));
+            ssRegDlgParamAsRunTimeParam(S, port, index, names[port].c_str(), type);
+            index++;
+        }
+    }
+
+    /**
+     * Updates the run-time parameters after the parameters are tuned (called
+     * in mdlProcessParameters).
+     */
+    static void updateRunTimeParameters(SimStruct *S) {
+        int index = 0;
+        for (int port = 0; port < ssGetSFcnParamsCount(S) && index < ssGetNumRunTimeParams(S); port++) {
+            if (getParameterDataTypeId(ssGetSFcnParam(S, port)) == INVALID_DTYPE_ID)
+                continue;
+            ssUpdateDlgParamAsRunTimeParam(S, index);
+            index++;
+        }
+    }
+
+    /** \ingroup initialization
+     * 
+     * This static method is called after the dimensions of the ports are 
+     * known, before the simulation starts.
+     * 
+     * This method should declare the data work vectors (DWork) of the block 
+     * using setDWorksCount and setDWork. Use DWorks rather than members of the 
+     * block for the persistent data of the block (matrices, buffers, states):
+     * their memory is allocated by Simulink and can be saved and restored.
+     * 
+     * The default method declares no DWork.
+     *
+     * For more information, see: http://www.mathworks.fr/help/simulink/sfg/mdlsetworkwidths.html */
+    static void initializeWorkVectors(SimStruct *S) {
     }
 
     /** \ingroup runtime
@@ -327,6 +1099,34 @@ public:
     void start() {
     }
 
+    /** \ingroup runtime
+     * 
+     * This optional method is called once after start and then each time 
+     * the user tunes the parameters during the simulation and at least one
+     * value has changed.
+     * 
+     * The method should compute the quantities derived from the parameters
+     * (factorizations, discretizations...). Use parameterChanged to recompute
+     * only what depends on the parameters that have changed.
+     *
+     * For more information, see: http://www.mathworks.fr/help/simulink/sfg/mdlprocessparameters.html */
+    void processParameters() {
+    }
+
+    /** \ingroup runtime
+     * 
+     * Reports an error to Simulink without throwing an exception. The 
+     * simulation stops when the current method returns.
+     * 
+     * In the exception-free profile (EASYLINK_EXCEPTION_FREE), runtime 
+     * methods must report their errors with this method and must not throw.
+     */
+    inline void setErrorStatus(const char *message) {
+        strncpy(ERROR_MSG_BUFFER, message, sizeof (ERROR_MSG_BUFFER) - 1);
+        ERROR_MSG_BUFFER[sizeof (ERROR_MSG_BUFFER) - 1] = '\0';
+        ssSetErrorStatus(simStruct, ERROR_MSG_BUFFER);
+    }
+
     /** \ingroup runtime
      * 
      * This method is called at each simulation time step.
@@ -340,6 +1140,30 @@ public:
     void outputs() {
     }
 
+    /** \ingroup runtime
+     * 
+     * This optional method replaces outputs in multi-rate blocks. It is 
+     * called for each sample time (rate) that has a hit at the current time 
+     * step, from the fastest to the slowest.
+     * 
+     * In multitasking mode, rates run in different tasks: data exchanged 
+     * between rates should go through a RateTransitionBuffer.
+     *
+     * For more information, see: http://www.mathworks.fr/help/simulink/sfg/sampletimes.html */
+    void outputsForRate(int rate) {
+    }
+
+    /** \ingroup runtime
+     * 
+     * This optional method replaces outputs when at least one input port 
+     * carries frames. It processes a whole frame at once: each channel of a
+     * frame port is a column of getInputFrameSize samples, contiguous in 
+     * memory, so that loops over the samples of a channel can be vectorized.
+     *
+     * For more information, see: http://www.mathworks.fr/help/simulink/sfg/frame-based-signals.html */
+    void outputsFrame() {
+    }
+
     /** \ingroup runtime
      * 
      * This optional method is called at each time step to compute the 
@@ -359,12 +1183,39 @@ public:
      * requires using the zero-crossing and mode work vectors to determine when
      * a zero crossing occurs and how the S-function's outputs should respond
      * to this event. The zeroCrossings method should update the S-function's
-     * zero-crossing vector, using nonSampledZCsArray.
+     * zero-crossing vector, using getZeroCrossingsArray or setZeroCrossing
+     * (see setZeroCrossingsCount and updateModes).
      *
      * For more information, see: http://www.mathworks.fr/help/simulink/sfg/mdlzerocrossings.html */
     void zeroCrossings() {
     }
 
+    /** \ingroup runtime
+     * 
+     * This optional method is called before outputs at major time steps only.
+     * 
+     * It should select the modes of the block from the inputs and the states 
+     * using setMode. The outputs and the zero crossings then depend on the 
+     * modes, which do not change during the minor steps of the solver.
+     *
+     * For more information, see: http://www.mathworks.fr/help/simulink/sfg/mdlzerocrossings.html */
+    void updateModes() {
+    }
+
+    /** \ingroup runtime
+     * 
+     * This optional method is called after outputs at each major time step of
+     * a block with a variable sample time (see setVariableSampleTime).
+     * 
+     * It returns the time of the next hit of the block, which must be greater
+     * than the current simulation time. Event-driven blocks keep their
+     * pending events in an EventQueue and return the time of the next one.
+     *
+     * For more information, see: http://www.mathworks.fr/help/simulink/sfg/mdlgettimeofnextvarhit.html */
+    double timeOfNextHit() {
+        return ssGetTFinal(simStruct);
+    }
+
     /** \ingroup runtime
      * 
      * This optional method is called at each major simulation time step. 
@@ -381,6 +1232,36 @@ public:
     void update() {
     }
 
+    /** \ingroup runtime
+     * 
+     * This optional method computes the Jacobian of the block:
+     * 
+     *     J = [ dx'/dx  dx'/du ]
+     *         [ dy/dx   dy/du  ]
+     * 
+     * where x are the continuous states, u all the input elements and y all
+     * the output elements.
+     * 
+     * The sparsity pattern must be declared once (in start) using 
+     * setJacobianPattern, setJacobianMask or setJacobianDense, and the
+     * maximum number of nonzero elements using setJacobianNzMax. This method
+     * then writes the nonzero values using getJacobianData, setJacobianValues
+     * or getJacobianMap.
+     *
+     * For more information, see: http://www.mathworks.fr/help/simulink/sfg/mdljacobian.html */
+    void jacobian() {
+    }
+
+    /** \ingroup runtime
+     * 
+     * This optional method replaces update in multi-rate blocks. It is 
+     * called for each sample time (rate) that has a hit at the current time
+     * step, from the fastest to the slowest.
+     *
+     * For more information, see: http://www.mathworks.fr/help/simulink/sfg/mdlupdate.html */
+    void updateForRate(int rate) {
+    }
+
     /** \ingroup runtime
      * 
      * This method is called when the simulation is terminated right before deleting the class.
@@ -392,14 +1273,88 @@ public:
     void terminate() {
     }
 
+    /** \ingroup runtime
+     * 
+     * This optional method saves and restores the data of the block that are
+     * not stored in DWorks or states (members of the block), using the 
+     * serialize methods of SimStateBuffer.
+     * 
+     * If this method is implemented, EasyLink saves the operating point 
+     * (SimState) of the block as a compact binary blob: the DWorks, the 
+     * states and the data serialized by this method. Otherwise, the 
+     * operating point compliance of the block is left unknown: a block 
+     * without other data can declare it in initializeOptions with 
+     * ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE).
+     *
+     * For more information, see: http://www.mathworks.fr/help/simulink/sfg/mdlgetsimstate.html */
+    void serializeState(SimStateBuffer & state) {
+    }
+
     /** \ingroup inputPort
      * 
-     * Returns the double scalar value of an input port.
+     * Returns the descriptor of an input port (data address, dimensions and
+     * type resolved when the simulation starts).
      */
-    static inline double getInputDouble(int port) {
-        if (port < 0 || port >= inputPortsCount)
-            throw std::runtime_error("Input port number " + toString(port) + " does not exist.");
-        return *ssGetInputPortRealSignal(simStruct, port);
+    inline const PortDescriptor& getInputDescriptor(int port) {
+        if (port < 0 || port >= (int) inputPorts.size())
+            EASYLINK_RUNTIME_ERROR_RETURN("Input port number " + toString(port) + " does not exist.", invalidPort);
+        PortDescriptor &input = inputPorts[port];
+        if (input.variableSize) {
+            // The current dimensions may change at each time step
+            input.nRows = ssGetCurrentInputPortDimensions(simStruct, port, 0);
+            input.nCols = ssGetInputPortNumDimensions(simStruct, port) > 1 ? ssGetCurrentInputPortDimensions(simStruct, port, 1) : 1;
+            input.width = input.nRows * input.nCols;
+        }
+        return input;
+    }
+
+    /** \ingroup inputPort
+     * 
+     * Returns the descriptor of an input port whose data are contiguous. 
+     * Throws an exception for non-contiguous ports.
+     */
+    inline const PortDescriptor& getContiguousInputDescriptor(int port) {
+        const PortDescriptor &input = getInputDescriptor(port);
+        if (input.pointers != NULL)
+            EASYLINK_RUNTIME_ERROR_RETURN("Input port number " + toString(port) + " is not contiguous. Use getInputView or gatherInput.", invalidPort);
+        return input;
+    }
+
+    /** \ingroup inputPort
+     * 
+     * Returns a view of an input port, contiguous or not (no data copy).
+     */
+    template<typename _Scalar>
+    inline InputPortView<_Scalar> getInputView(int port) {
+        const PortDescriptor &input = getInputDescriptor(port);
+        return InputPortView<_Scalar>((const _Scalar*) input.data, input.pointers, input.nRows, input.nCols);
+    }
+
+    /** \ingroup inputPort
+     * 
+     * Returns a pointer to a contiguous copy of the elements of an input port.
+     * 
+     * The elements of a non-contiguous port are copied to a staging buffer
+     * allocated when the simulation starts. The data of a contiguous port are
+     * returned without copy.
+     */
+    inline const void* gatherInput(int port) {
+        const PortDescriptor &input = getInputDescriptor(port);
+        if (input.pointers == NULL)
+            return input.data;
+        size_t size = (size_t) ssGetDataTypeSize(simStruct, input.type);
+        unsigned char *staging = (unsigned char*) inputPorts[port].staging.data();
+        for (int i = 0; i < input.width; i++)
+            memcpy(staging + i * size, input.pointers[i], size);
+        return staging;
+    }
+
+    /** \ingroup inputPort
+     * 
+     * Returns the double scalar value of an input port.
+     */
+    inline double getInputDouble(int port) {
+        return *((const double*) getContiguousInputDescriptor(port).data);
     }
 
     /** \ingroup inputPort
@@ -407,10 +1362,8 @@ public:
      * Returns the scalar value of an input port.
      */
     template<typename _Scalar>
-    static inline _Scalar getInputScalar(int port) {
-        if (port < 0 || port >= inputPortsCount)
-            throw std::runtime_error("Input port number " + toString(port) + " does not exist.");
-        return *((_Scalar*) ssGetInputPortSignal(simStruct, port));
+    inline _Scalar getInputScalar(int port) {
+        return *((const _Scalar*) getContiguousInputDescriptor(port).data);
     }
 
     /** \ingroup inputPort
@@ -418,20 +1371,59 @@ public:
      * Returns an array mapping an input port.
      */
     template<typename _Scalar>
-    static inline Array<_Scalar> getInputArray(int port) {
-        if (port < 0 || port >= inputPortsCount)
-            throw std::runtime_error("Input port number " + toString(port) + " does not exist.");
-        return Array<_Scalar>((_Scalar*) ssGetInputPortSignal(simStruct, port), ssGetInputPortDimensionSize(simStruct, port, 0), ssGetInputPortDimensionSize(simStruct, port, 1), "input port " + toString(port), true);
+    inline Array<_Scalar> getInputArray(int port) {
+        const PortDescriptor &input = getContiguousInputDescriptor(port);
+        return Array<_Scalar>((_Scalar*) input.data, input.nRows, input.nCols, input.name, true);
     }
 
     /** \ingroup inputPort
      * 
      * Returns a pointer to the first element of the input port data.
      */
-    static inline void* getInputData(int port) {
-        if (port < 0 || port >= inputPortsCount)
-            throw std::runtime_error("Input port number " + toString(port) + " does not exist.");
-        return (void*) ssGetInputPortSignal(simStruct, port);
+    inline void* getInputData(int port) {
+        return getContiguousInputDescriptor(port).data;
+    }
+
+    /** \ingroup inputPort
+     * 
+     * Returns a map of an input port (no data copy), for instance an 
+     * Eigen::Map (see EigenBridge.h).
+     * 
+     * The compile-time dimensions of the map must agree with the port.
+     */
+    template<typename _Map>
+    inline _Map getInputMap(int port) {
+        const PortDescriptor &input = getContiguousInputDescriptor(port);
+        if (!isMapSizeValid<_Map>(input.nRows, input.nCols))
+            EASYLINK_RUNTIME_ERROR_RETURN("Input port number " + toString(port) + " does not have the dimensions of the map.", getInvalidMap<_Map>(input.nRows, input.nCols));
+        return _Map((typename _Map::PointerArgType) input.data, input.nRows, input.nCols);
+    }
+
+    /** \ingroup inputPort
+     * 
+     * Returns a reference to the struct of an input bus port (no data copy).
+     */
+    template<typename _Bus>
+    inline const _Bus& getInputBus(int port) {
+        const PortDescriptor &input = getInputDescriptor(port);
+        if (&input == &invalidPort)
+            return *getInvalidBus<_Bus>();
+        return *((const _Bus*) input.data);
+    }
+
+    /** \ingroup inputPort
+     * 
+     * Checks that the layout of a C++ struct matches the bus of an input 
+     * port (call it in start).
+     * 
+     * \code{.cpp}
+     *     assertInputBusLayout<LimitsBus>(0, {offsetof(LimitsBus, lower), offsetof(LimitsBus, upper)});
+     * \endcode
+     */
+    template<typename _Bus>
+    inline void assertInputBusLayout(int port, std::initializer_list<size_t> offsets = {}) {
+        const PortDescriptor &input = getInputDescriptor(port);
+        assertBusLayout<_Bus>(simStruct, input.type, offsets, input.name);
     }
 
     /** \ingroup inputPort
@@ -442,35 +1434,106 @@ public:
      * 
      * If the input port is an M-by-N array, this function returns m*n.
      */
-    static inline int getInputWidth(int port) {
-        return ssGetInputPortWidth(simStruct, port);
+    inline int getInputWidth(int port) {
+        return getInputDescriptor(port).width;
     }
 
     /** \ingroup inputPort
      * 
      * Returns the input port number of rows.
      */
-    static inline int getInputNRows(int port) {
-        return ssGetInputPortDimensionSize(simStruct, port, 0);
+    inline int getInputNRows(int port) {
+        return getInputDescriptor(port).nRows;
     }
 
     /** \ingroup inputPort
      * 
      * Returns the input port number of cols.
      */
-    static inline int getInputNCols(int port) {
-        return ssGetInputPortDimensionSize(simStruct, port, 1);
+    inline int getInputNCols(int port) {
+        return getInputDescriptor(port).nCols;
+    }
+
+    /** \ingroup inputPort
+     * 
+     * Returns true if the input port carries frames.
+     */
+    inline bool isInputFrame(int port) {
+        return getInputDescriptor(port).frame;
+    }
+
+    /** \ingroup inputPort
+     * 
+     * Returns the number of samples per frame of an input port (the number
+     * of rows, 1 if the port does not carry frames).
+     */
+    inline int getInputFrameSize(int port) {
+        const PortDescriptor &input = getInputDescriptor(port);
+        return input.frame ? input.nRows : 1;
+    }
+
+    /** \ingroup inputPort
+     * 
+     * Returns the number of channels of an input port (the number of cols of
+     * a frame port, the width of a sample port).
+     */
+    inline int getInputChannelsCount(int port) {
+        const PortDescriptor &input = getInputDescriptor(port);
+        return input.frame ? input.nCols : input.width;
+    }
+
+    /** \ingroup inputPort
+     * 
+     * Returns true if at least one input port carries frames.
+     */
+    inline bool hasFrameInputs() {
+        for (int port = 0; port < (int) inputPorts.size(); port++)
+            if (inputPorts[port].frame)
+                return true;
+        return false;
+    }
+
+    /** \ingroup outputPort
+     * 
+     * Returns the descriptor of an output port (data address, dimensions and
+     * type resolved when the simulation starts).
+     */
+    inline const PortDescriptor& getOutputDescriptor(int port) {
+        if (port < 0 || port >= (int) outputPorts.size())
+            EASYLINK_RUNTIME_ERROR_RETURN("Output port number " + toString(port) + " does not exist.", invalidPort);
+        return outputPorts[port];
+    }
+
+    /** \ingroup outputPort
+     * 
+     * Sets the current dimensions of a variable-size output port. The 
+     * current dimensions must not exceed the dimensions of the port.
+     * 
+     * Output accessors then report the current dimensions, so that the 
+     * block only writes the active extent of the port.
+     */
+    inline void setOutputCurrentSizes(int port, int nRows, int nCols = 1) {
+        if (port < 0 || port >= (int) outputPorts.size())
+            EASYLINK_RUNTIME_ERROR("Output port number " + toString(port) + " does not exist.");
+        PortDescriptor &output = outputPorts[port];
+        if (!output.variableSize)
+            EASYLINK_RUNTIME_ERROR("Output port number " + toString(port) + " is not a variable-size port.");
+        if (nRows < 0 || nCols < 0 || nRows > output.maxNRows || nCols > output.maxNCols)
+            EASYLINK_RUNTIME_ERROR("Output port number " + toString(port) + " cannot have " + toString(nRows) + " rows and " + toString(nCols) + " cols.");
+        ssSetCurrentOutputPortDimensions(simStruct, port, 0, nRows);
+        if (ssGetOutputPortNumDimensions(simStruct, port) > 1)
+            ssSetCurrentOutputPortDimensions(simStruct, port, 1, nCols);
+        output.nRows = nRows;
+        output.nCols = nCols;
+        output.width = nRows * nCols;
     }
 
     /** \ingroup outputPort
      * 
      * Writes a double value to an output port.
      */
-    static inline void setOutputDouble(int port, double value) {
-        if (port < 0 || port >= outputPortsCount)
-            throw std::runtime_error("Output port number " + toString(port) + " does not exist.");
-        double *x = ssGetOutputPortRealSignal(simStruct, port);
-        x[0] = value;
+    inline void setOutputDouble(int port, double value) {
+        *((double*) getOutputDescriptor(port).data) = value;
     }
 
     /** \ingroup outputPort
@@ -478,11 +1541,8 @@ public:
      * Writes a scalar value to an output port.
      */
     template<typename _Scalar>
-    static inline void setOutputScalar(int port, _Scalar value) {
-        if (port < 0 || port >= outputPortsCount)
-            throw std::runtime_error("Output port number " + toString(port) + " does not exist.");
-        _Scalar *x = ssGetOutputPortSignal(simStruct, port);
-        x[0] = value;
+    inline void setOutputScalar(int port, _Scalar value) {
+        *((_Scalar*) getOutputDescriptor(port).data) = value;
     }
 
     /** \ingroup outputPort
@@ -490,19 +1550,73 @@ public:
      * Returns an array mapping an output port (left-side argument).
      */
     template<typename _Scalar>
-    static inline Array<_Scalar> getOutputArray(int port) {
-        if (port < 0 || port >= outputPortsCount)
-            throw std::runtime_error("Output port number " + toString(port) + " does not exist.");
-        return Array<_Scalar>((_Scalar*) ssGetOutputPortSignal(simStruct, port), ssGetOutputPortDimensionSize(simStruct, port, 0), ssGetOutputPortDimensionSize(simStruct, port, 1), "output port " + toString(port), true);
+    inline Array<_Scalar> getOutputArray(int port) {
+        const PortDescriptor &output = getOutputDescriptor(port);
+        return Array<_Scalar>((_Scalar*) output.data, output.nRows, output.nCols, output.name, true);
+    }
+
+    /** \ingroup outputPort
+     * 
+     * Returns an array mapping an output port that holds the values of an 
+     * input port, to be transformed in place (see setInPlacePair).
+     * 
+     * If Simulink reuses the input buffer for the output, no data is copied.
+     * Otherwise, the input is first copied to the output.
+     */
+    template<typename _Scalar>
+    inline Array<_Scalar> getInPlaceArray(int inputPort, int outputPort) {
+        const PortDescriptor &input = getContiguousInputDescriptor(inputPort);
+        const PortDescriptor &output = getOutputDescriptor(outputPort);
+        if (input.width != output.width || input.type != output.type)
+            EASYLINK_RUNTIME_ERROR_RETURN("Input port number " + toString(inputPort) + " and output port number " + toString(outputPort) + " do not have the same dimensions and type.", Array<_Scalar>((_Scalar*) output.data, output.nRows, output.nCols, output.name, true));
+        if (output.data != input.data)
+            memcpy(output.data, input.data, (size_t) output.width * sizeof (_Scalar));
+        return Array<_Scalar>((_Scalar*) output.data, output.nRows, output.nCols, output.name, true);
     }
 
     /** \ingroup outputPort
      * Returns a pointer to the first element of the output port data.
      */
-    static inline void* getOutputData(int port) {
-        if (port < 0 || port >= outputPortsCount)
-            throw std::runtime_error("Output port number " + toString(port) + " does not exist.");
-        return (void*) ssGetOutputPortSignal(simStruct, port);
+    inline void* getOutputData(int port) {
+        return getOutputDescriptor(port).data;
+    }
+
+    /** \ingroup outputPort
+     * 
+     * Returns a map of an output port (no data copy), for instance an 
+     * Eigen::Map (see EigenBridge.h).
+     * 
+     * The compile-time dimensions of the map must agree with the port.
+     */
+    template<typename _Map>
+    inline _Map getOutputMap(int port) {
+        const PortDescriptor &output = getOutputDescriptor(port);
+        if (!isMapSizeValid<_Map>(output.nRows, output.nCols))
+            EASYLINK_RUNTIME_ERROR_RETURN("Output port number " + toString(port) + " does not have the dimensions of the map.", getInvalidMap<_Map>(output.nRows, output.nCols));
+        return _Map((typename _Map::PointerArgType) output.data, output.nRows, output.nCols);
+    }
+
+    /** \ingroup outputPort
+     * 
+     * Returns a reference to the struct of an output bus port (no data copy).
+     */
+    template<typename _Bus>
+    inline _Bus& getOutputBus(int port) {
+        const PortDescriptor &output = getOutputDescriptor(port);
+        if (&output == &invalidPort)
+            return *getInvalidBus<_Bus>();
+        return *((_Bus*) output.data);
+    }
+
+    /** \ingroup outputPort
+     * 
+     * Checks that the layout of a C++ struct matches the bus of an output 
+     * port (call it in start).
+     */
+    template<typename _Bus>
+    inline void assertOutputBusLayout(int port, std::initializer_list<size_t> offsets = {}) {
+        const PortDescriptor &output = getOutputDescriptor(port);
+        assertBusLayout<_Bus>(simStruct, output.type, offsets, output.name);
     }
 
     /** \ingroup outputPort
@@ -513,34 +1627,65 @@ public:
      * 
      * If the output port is an M-by-N array, this function returns m*n.
      */
-    static inline int getOutputWidth(int port) {
-        return ssGetOutputPortWidth(simStruct, port);
+    inline int getOutputWidth(int port) {
+        return getOutputDescriptor(port).width;
     }
 
     /** \ingroup outputPort
      * 
      * Returns the output port number of rows.
      */
-    static inline int getOutputNRows(int port) {
-        return ssGetOutputPortDimensionSize(simStruct, port, 0);
+    inline int getOutputNRows(int port) {
+        return getOutputDescriptor(port).nRows;
     }
 
     /** \ingroup outputPort
      * 
      * Returns the output port number of cols.
      */
-    static inline int getOutputNCols(int port) {
-        return ssGetOutputPortDimensionSize(simStruct, port, 1);
+    inline int getOutputNCols(int port) {
+        return getOutputDescriptor(port).nCols;
+    }
+
+    /** \ingroup parameterPort
+     * 
+     * Returns the cached value of a parameter port.
+     * 
+     * Parameter values are copied when the simulation starts and each time
+     * the parameters are tuned: runtime accessors do not read the mxArrays.
+     */
+    inline const ParameterDescriptor& getParameterDescriptor(int port) {
+        if (port < 0 || port >= (int) parameters.size())
+            EASYLINK_RUNTIME_ERROR_RETURN("Parameter port number " + toString(port) + " does not exist.", invalidParameter);
+        return parameters[port];
+    }
+
+    /** \ingroup parameterPort
+     * 
+     * Returns true if the value of a parameter port has changed during the 
+     * last tuning (always true in the first call of processParameters).
+     */
+    inline bool parameterChanged(int port) {
+        return getParameterDescriptor(port).changed;
     }
 
     /** \ingroup parameterPort
      * 
      * Returns the double value of a parameter port.
+     * 
+     * Parameter getters exist in two forms: a static form taking the 
+     * SimStruct, for static methods (sizing, checks), which reads the 
+     * mxArray, and a member form for runtime methods, which reads the cached
+     * value.
      */
-    static inline double getParameterDouble(int port) {
-        if (port < 0 || port >= parameterPortsCount)
+    static inline double getParameterDouble(SimStruct *S, int port) {
+        if (port < 0 || port >= ssGetSFcnParamsCount(S))
             throw std::runtime_error("Parameter port number " + toString(port) + " does not exist.");
-        return mxGetPr(ssGetSFcnParam(simStruct, port))[0];
+        return mxGetPr(ssGetSFcnParam(S, port))[0];
+    }
+
+    inline double getParameterDouble(int port) {
+        return *((double*) getParameterDescriptor(port).data);
     }
 
     /** \ingroup parameterPort
@@ -548,22 +1693,32 @@ public:
      * Returns the scalar value of a parameter port.
      */
     template<typename _Scalar>
-    static inline _Scalar getParameterScalar(int port) {
-        if (port < 0 || port >= parameterPortsCount)
+    static inline _Scalar getParameterScalar(SimStruct *S, int port) {
+        if (port < 0 || port >= ssGetSFcnParamsCount(S))
             throw std::runtime_error("Parameter port number " + toString(port) + " does not exist.");
-        return *((_Scalar*) mxGetPr(ssGetSFcnParam(simStruct, port)));
+        return *((_Scalar*) mxGetData(ssGetSFcnParam(S, port)));
+    }
+
+    template<typename _Scalar>
+    inline _Scalar getParameterScalar(int port) {
+        return *((_Scalar*) getParameterDescriptor(port).data);
     }
 
     /** \ingroup parameterPort
      * 
      * Returns the string value of a parameter port.
      */
-    static inline std::string getParameterString(int port) {
-        if (port < 0 || port >= parameterPortsCount)
+    static inline std::string getParameterString(SimStruct *S, int port) {
+        if (port < 0 || port >= ssGetSFcnParamsCount(S))
             throw std::runtime_error("Parameter port number " + toString(port) + " does not exist.");
-        char buffer[256];
-        mxGetString(ssGetSFcnParam(simStruct, port), buffer, 256);
-        return std::string(buffer);
+        const mxArray *mxarray = ssGetSFcnParam(S, port);
+        std::vector<char> buffer(mxGetNumberOfElements(mxarray) + 1);
+        mxGetString(mxarray, &buffer[0], (mwSize) buffer.size());
+        return std::string(&buffer[0]);
+    }
+
+    inline const std::string& getParameterString(int port) {
+        return getParameterDescriptor(port).string;
     }
 
     /** \ingroup parameterPort
@@ -571,10 +1726,16 @@ public:
      * Returns an array mapping a parameter port.
      */
     template<typename _Scalar>
-    static inline Array<_Scalar> getParameterArray(int port) {
-        if (port < 0 || port >= parameterPortsCount)
+    static inline Array<_Scalar> getParameterArray(SimStruct *S, int port) {
+        if (port < 0 || port >= ssGetSFcnParamsCount(S))
             throw std::runtime_error("Parameter port number " + toString(port) + " does not exist.");
-        return Array<_Scalar>(ssGetSFcnParam(simStruct, port), "parameter " + toString(port), true);
+        return Array<_Scalar>(ssGetSFcnParam(S, port), "parameter " + toString(port), true);
+    }
+
+    template<typename _Scalar>
+    inline Array<_Scalar> getParameterArray(int port) {
+        const ParameterDescriptor &parameter = getParameterDescriptor(port);
+        return Array<_Scalar>((_Scalar*) parameter.data, parameter.nRows, parameter.nCols, parameter.name, true);
     }
 
     /** \ingroup parameterPort
@@ -585,39 +1746,79 @@ public:
      * 
      * If the parameter port is an M-by-N array, this function returns m*n.
      */
-    static inline int getParameterWidth(int port) {
-        return (int) mxGetM(ssGetSFcnParam(simStruct, port))*(int) mxGetN(ssGetSFcnParam(simStruct, port));
+    static inline int getParameterWidth(SimStruct *S, int port) {
+        return (int) mxGetM(ssGetSFcnParam(S, port))*(int) mxGetN(ssGetSFcnParam(S, port));
+    }
+
+    inline int getParameterWidth(int port) {
+        return getParameterDescriptor(port).width;
     }
 
     /** \ingroup parameterPort
      * 
      * Returns the parameter port number of rows.
      */
-    static inline int getParameterNRows(int port) {
-        return (int) mxGetM(ssGetSFcnParam(simStruct, port));
+    static inline int getParameterNRows(SimStruct *S, int port) {
+        return (int) mxGetM(ssGetSFcnParam(S, port));
+    }
+
+    inline int getParameterNRows(int port) {
+        return getParameterDescriptor(port).nRows;
     }
 
     /** \ingroup parameterPort
      * 
      * Returns the parameter port number of cols.
      */
-    static inline int getParameterNCols(int port) {
-        return (int) mxGetN(ssGetSFcnParam(simStruct, port));
+    static inline int getParameterNCols(SimStruct *S, int port) {
+        return (int) mxGetN(ssGetSFcnParam(S, port));
+    }
+
+    inline int getParameterNCols(int port) {
+        return getParameterDescriptor(port).nCols;
     }
 
     /** \ingroup parameterPort
      * 
      * Returns a pointer to the first element of the parameter port data.
      */
-    static inline void* getParameterData(int port) {
-        return (void*) ssGetSFcnParam(simStruct, port);
+    static inline void* getParameterData(SimStruct *S, int port) {
+        return mxGetData(ssGetSFcnParam(S, port));
+    }
+
+    inline void* getParameterData(int port) {
+        return getParameterDescriptor(port).data;
+    }
+
+    /** \ingroup parameterPort
+     * 
+     * Returns a map of a parameter port (no data copy), for instance an 
+     * Eigen::Map (see EigenBridge.h).
+     * 
+     * The compile-time dimensions of the map must agree with the parameter.
+     */
+    template<typename _Map>
+    static inline _Map getParameterMap(SimStruct *S, int port) {
+        int nRows = getParameterNRows(S, port);
+        int nCols = getParameterNCols(S, port);
+        if (!isMapSizeValid<_Map>(nRows, nCols))
+            throw std::runtime_error("Parameter port number " + toString(port) + " does not have the dimensions of the map.");
+        return _Map((typename _Map::PointerArgType) getParameterData(S, port), nRows, nCols);
+    }
+
+    template<typename _Map>
+    inline _Map getParameterMap(int port) {
+        const ParameterDescriptor &parameter = getParameterDescriptor(port);
+        if (!isMapSizeValid<_Map>(parameter.nRows, parameter.nCols))
+            EASYLINK_RUNTIME_ERROR_RETURN("Parameter port number " + toString(port) + " does not have the dimensions of the map.", getInvalidMap<_Map>(parameter.nRows, parameter.nCols));
+        return _Map((typename _Map::PointerArgType) parameter.data, parameter.nRows, parameter.nCols);
     }
 
     /** \ingroup statePort
      * 
      * Returns the continuous state Array (1-D array).
      */
-    static inline Array<double> getContinuousStateArray() {
+    inline Array<double> getContinuousStateArray() {
         return Array<double>(ssGetContStates(simStruct), ssGetNumContStates(simStruct), 1, "continuous state", true);
     }
 
@@ -625,7 +1826,7 @@ public:
      * 
      * Returns a pointer to the first element of the state data (1-D array).
      */
-    static inline double* getContinuousStateData() {
+    inline double* getContinuousStateData() {
         return (double*) ssGetContStates(simStruct);
     }
 
@@ -633,16 +1834,29 @@ public:
      * 
      * Returns the continuous state number of elements (1-D array).
      */
-    static inline int getContinuousStateWidth() {
+    inline int getContinuousStateWidth() {
 
         return ssGetNumContStates(simStruct);
     }
 
+    /** \ingroup statePort
+     * 
+     * Returns a map of the continuous state (1-D array), for instance an 
+     * Eigen::Map (see EigenBridge.h).
+     */
+    template<typename _Map>
+    inline _Map getContinuousStateMap() {
+        int width = ssGetNumContStates(simStruct);
+        if (!isMapSizeValid<_Map>(width, 1))
+            EASYLINK_RUNTIME_ERROR_RETURN("The continuous state does not have the dimensions of the map.", getInvalidMap<_Map>(width, 1));
+        return _Map(ssGetContStates(simStruct), width, 1);
+    }
+
     /** \ingroup statePort
      * 
      * Returns the derivative state Array (1-D array).
      */
-    static inline Array<double> getDerivativeStateArray() {
+    inline Array<double> getDerivativeStateArray() {
         return Array<double>((double*) ssGetdX(simStruct), ssGetNumContStates(simStruct), 1, "continuous state", true);
     }
 
@@ -650,17 +1864,30 @@ public:
      * 
      * Returns a pointer to the first element of the derivative state data (1-D array).
      */
-    static inline double* getDerivativeStateData() {
+    inline double* getDerivativeStateData() {
         return (double*) ssGetdX(simStruct);
     }
 
+    /** \ingroup statePort
+     * 
+     * Returns a map of the derivative state (1-D array), for instance an 
+     * Eigen::Map (see EigenBridge.h).
+     */
+    template<typename _Map>
+    inline _Map getDerivativeStateMap() {
+        int width = ssGetNumContStates(simStruct);
+        if (!isMapSizeValid<_Map>(width, 1))
+            EASYLINK_RUNTIME_ERROR_RETURN("The derivative state does not have the dimensions of the map.", getInvalidMap<_Map>(width, 1));
+        return _Map((double*) ssGetdX(simStruct), width, 1);
+    }
+
     /** \ingroup statePort
      * 
      * Writes the derivative state Array (1-D array).
      */
-    static inline void setDerivativeStateArray(Array<double> & array) {
+    inline void setDerivativeStateArray(Array<double> & array) {
         if (ssGetNumContStates(simStruct) != array.getNRows() || array.getNCols() != 1)
-            throw std::runtime_error("Unable to write " + array.getName() + " to derivative of state port. Array dimensions must agree.");
+            EASYLINK_RUNTIME_ERROR("Unable to write " + array.getName() + " to derivative of state port. Array dimensions must agree.");
 
         memcpy((void*) ssGetdX(simStruct), (void*) array.getData(), array.getWidth() * sizeof (double));
     }
@@ -669,7 +1896,7 @@ public:
      * 
      * Returns the discrete state Array (1-D array).
      */
-    static inline Array<double> getDiscreteStateArray() {
+    inline Array<double> getDiscreteStateArray() {
         return Array<double>((double*) ssGetDiscStates(simStruct), ssGetNumDiscStates(simStruct), 1, "discrete state", true);
     }
 
@@ -677,15 +1904,28 @@ public:
      * 
      * Returns a pointer to the first element of the discrete state data (1-D array).
      */
-    static inline double* getDiscreteStateData() {
+    inline double* getDiscreteStateData() {
         return (double*) ssGetDiscStates(simStruct);
     }
 
+    /** \ingroup statePort
+     * 
+     * Returns a map of the discrete state (1-D array), for instance an 
+     * Eigen::Map (see EigenBridge.h).
+     */
+    template<typename _Map>
+    inline _Map getDiscreteStateMap() {
+        int width = ssGetNumDiscStates(simStruct);
+        if (!isMapSizeValid<_Map>(width, 1))
+            EASYLINK_RUNTIME_ERROR_RETURN("The discrete state does not have the dimensions of the map.", getInvalidMap<_Map>(width, 1));
+        return _Map((double*) ssGetDiscStates(simStruct), width, 1);
+    }
+
     /** \ingroup statePort
      * 
      * Returns the discrete state number of elements (1-D array).
      */
-    static inline int getDiscreteStateWidth(int port) {
+    inline int getDiscreteStateWidth(int port) {
         return ssGetNumDiscStates(simStruct);
     }
 
@@ -693,26 +1933,371 @@ public:
      * 
      * Writes the discrete state Array (1-D array).
      */
-    static inline void setDiscreteStateArray(Array<double> & array) {
+    inline void setDiscreteStateArray(Array<double> & array) {
         if (ssGetNumDiscStates(simStruct) != array.getNRows() || array.getNCols() != 1)
-            throw std::runtime_error("Unable to write " + array.getName() + " to discrete state port. Array dimensions must agree.");
+            EASYLINK_RUNTIME_ERROR("Unable to write " + array.getName() + " to discrete state port. Array dimensions must agree.");
 
         memcpy((void*) ssGetDiscStates(simStruct), (void*) array.getData(), array.getWidth() * sizeof (double));
     }
 
+    /** \ingroup workPort
+     * 
+     * Returns the number of elements of a data work vector (DWork).
+     */
+    inline int getDWorkWidth(int index) {
+        if (index < 0 || index >= ssGetNumDWork(simStruct))
+            EASYLINK_RUNTIME_ERROR_RETURN("DWork number " + toString(index) + " does not exist.", 0);
+        return ssGetDWorkWidth(simStruct, index);
+    }
+
+    /** \ingroup workPort
+     * 
+     * Returns a pointer to the first element of a data work vector (DWork).
+     */
+    inline void* getDWorkData(int index) {
+        if (index < 0 || index >= ssGetNumDWork(simStruct))
+            EASYLINK_RUNTIME_ERROR_RETURN("DWork number " + toString(index) + " does not exist.", (void*) invalidData);
+        return ssGetDWork(simStruct, index);
+    }
+
+    /** \ingroup workPort
+     * 
+     * Returns an array mapping a data work vector (DWork).
+     * 
+     * DWorks are 1-D arrays. If nRows is positive, the array is mapped as a
+     * nRows-by-(width/nRows) matrix.
+     */
+    template<typename _Scalar>
+    inline Array<_Scalar> getDWorkArray(int index, int nRows = -1) {
+        int width = getDWorkWidth(index);
+        if (nRows <= 0)
+            nRows = width;
+        if (nRows == 0 || width % nRows != 0)
+            EASYLINK_RUNTIME_ERROR_RETURN("DWork number " + toString(index) + " cannot be mapped with " + toString(nRows) + " rows.", Array<_Scalar>((_Scalar*) invalidData, 0, 0, "invalid DWork", true));
+        return Array<_Scalar>((_Scalar*) getDWorkData(index), nRows, width / nRows, "DWork " + toString(index), true);
+    }
+
+    /** \ingroup workPort
+     * 
+     * Returns a map of a data work vector (DWork), for instance an Eigen::Map
+     * (see EigenBridge.h).
+     * 
+     * DWorks are 1-D arrays. If nRows is positive, the DWork is mapped as a
+     * nRows-by-(width/nRows) matrix.
+     */
+    template<typename _Map>
+    inline _Map getDWorkMap(int index, int nRows = -1) {
+        int width = getDWorkWidth(index);
+        if (nRows <= 0)
+            nRows = width;
+        if (nRows == 0 || width % nRows != 0 || !isMapSizeValid<_Map>(nRows, width / nRows))
+            EASYLINK_RUNTIME_ERROR_RETURN("DWork number " + toString(index) + " does not have the dimensions of the map.", getInvalidMap<_Map>(nRows, nRows > 0 ? width / nRows : 0));
+        return _Map((typename _Map::PointerArgType) getDWorkData(index), nRows, width / nRows);
+    }
+
+    /** \ingroup statePort
+     * 
+     * Returns the number of nonsampled zero-crossing signals.
+     */
+    inline int getZeroCrossingsCount() {
+        return ssGetNumNonsampledZCs(simStruct);
+    }
+
+    /** \ingroup statePort
+     * 
+     * Returns the Array of the nonsampled zero-crossing signals (no data copy).
+     */
+    inline Array<double> getZeroCrossingsArray() {
+        return Array<double>(ssGetNonsampledZCs(simStruct), ssGetNumNonsampledZCs(simStruct), 1, "zero crossings", true);
+    }
+
+    /** \ingroup statePort
+     * 
+     * Sets the value of a zero-crossing signal.
+     */
+    inline void setZeroCrossing(int index, double value) {
+        if (index < 0 || index >= ssGetNumNonsampledZCs(simStruct))
+            EASYLINK_RUNTIME_ERROR("Zero crossing number " + toString(index) + " does not exist.");
+        ssGetNonsampledZCs(simStruct)[index] = value;
+    }
+
+    /** \ingroup statePort
+     * 
+     * Returns the number of modes.
+     */
+    inline int getModesCount() {
+        return ssGetNumModes(simStruct);
+    }
+
+    /** \ingroup statePort
+     * 
+     * Returns the Array of the modes (no data copy).
+     */
+    inline Array<int> getModesArray() {
+        return Array<int>(ssGetModeVector(simStruct), ssGetNumModes(simStruct), 1, "modes", true);
+    }
+
+    /** \ingroup statePort
+     * 
+     * Returns the value of a mode.
+     */
+    inline int getMode(int index) {
+        if (index < 0 || index >= ssGetNumModes(simStruct))
+            EASYLINK_RUNTIME_ERROR_RETURN("Mode number " + toString(index) + " does not exist.", 0);
+        return ssGetModeVector(simStruct)[index];
+    }
+
+    /** \ingroup statePort
+     * 
+     * Sets the value of a mode (in updateModes).
+     */
+    inline void setMode(int index, int mode) {
+        if (index < 0 || index >= ssGetNumModes(simStruct))
+            EASYLINK_RUNTIME_ERROR("Mode number " + toString(index) + " does not exist.");
+        ssGetModeVector(simStruct)[index] = mode;
+    }
+
+    /** Returns true during a major time step of the solver. */
+    inline bool isMajorTimeStep() {
+        return ssIsMajorTimeStep(simStruct);
+    }
+
+    /** \ingroup statePort
+     * 
+     * Returns the number of rows of the Jacobian (continuous states and 
+     * output elements).
+     */
+    inline int getJacobianNRows() {
+        int nRows = ssGetNumContStates(simStruct);
+        for (int port = 0; port < (int) outputPorts.size(); port++)
+            nRows += outputPorts[port].width;
+        return nRows;
+    }
+
+    /** \ingroup statePort
+     * 
+     * Returns the number of cols of the Jacobian (continuous states and 
+     * input elements).
+     */
+    inline int getJacobianNCols() {
+        int nCols = ssGetNumContStates(simStruct);
+        for (int port = 0; port < (int) inputPorts.size(); port++)
+            nCols += inputPorts[port].width;
+        return nCols;
+    }
+
+    /** \ingroup statePort
+     * 
+     * Sets the sparsity pattern of the Jacobian from a compressed 
+     * column-major sparse matrix, for instance an Eigen::SparseMatrix (call
+     * makeCompressed first).
+     */
+    template<typename _Sparse>
+    void setJacobianPattern(const _Sparse & pattern) {
+        if (pattern.rows() != getJacobianNRows() || pattern.cols() != getJacobianNCols())
+            throw std::runtime_error("The Jacobian must have " + toString(getJacobianNRows()) + " rows and " + toString(getJacobianNCols()) + " cols.");
+        jacobianColumnStarts.assign(pattern.outerIndexPtr(), pattern.outerIndexPtr() + pattern.cols() + 1);
+        jacobianRowIndices.assign(pattern.innerIndexPtr(), pattern.innerIndexPtr() + pattern.nonZeros());
+        jacobianPatternWritten = false;
+        jacobianColoring.clear();
+    }
+
+    /** \ingroup statePort
+     * 
+     * Sets the sparsity pattern of the Jacobian from a mask: the element 
+     * (row, col) is nonzero if mask(row, col) is true.
+     */
+    template<typename _Mask>
+    void setJacobianMask(_Mask && mask) {
+        int nRows = getJacobianNRows();
+        int nCols = getJacobianNCols();
+        jacobianColumnStarts.assign(1, 0);
+        jacobianRowIndices.clear();
+        for (int col = 0; col < nCols; col++) {
+            for (int row = 0; row < nRows; row++)
+                if (mask(row, col))
+                    jacobianRowIndices.push_back(row);
+            jacobianColumnStarts.push_back((int) jacobianRowIndices.size());
+        }
+        jacobianPatternWritten = false;
+        jacobianColoring.clear();
+    }
+
+    /** \ingroup statePort
+     * 
+     * Sets a dense sparsity pattern: all the elements of the Jacobian are 
+     * written, in column-major order (see getJacobianMap).
+     */
+    void setJacobianDense() {
+        int nRows = getJacobianNRows();
+        int nCols = getJacobianNCols();
+        jacobianColumnStarts.resize(nCols + 1);
+        jacobianRowIndices.resize((size_t) nRows * nCols);
+        for (int col = 0; col <= nCols; col++)
+            jacobianColumnStarts[col] = col * nRows;
+        for (int i = 0; i < nRows * nCols; i++)
+            jacobianRowIndices[i] = i % nRows;
+        jacobianPatternWritten = false;
+        jacobianColoring.clear();
+    }
+
+    /** Writes the sparsity pattern of the Jacobian to Simulink (called by 
+     * mdlJacobian, once). */
+    void writeJacobianPattern() {
+        if (jacobianPatternWritten)
+            return;
+        if (jacobianColumnStarts.empty())
+            throw std::runtime_error("The sparsity pattern of the Jacobian is not set.");
+        if ((int) jacobianRowIndices.size() > ssGetJacobianNzMax(simStruct))
+            throw std::runtime_error("The Jacobian has " + toString(jacobianRowIndices.size()) + " nonzero elements, more than declared with setJacobianNzMax.");
+        std::copy(jacobianColumnStarts.begin(), jacobianColumnStarts.end(), ssGetJacobianJc(simStruct));
+        std::copy(jacobianRowIndices.begin(), jacobianRowIndices.end(), ssGetJacobianIr(simStruct));
+        jacobianPatternWritten = true;
+    }
+
+    /** \ingroup statePort
+     * 
+     * Returns the nonzero values of the Jacobian, in the order of the 
+     * sparsity pattern.
+     */
+    inline double* getJacobianData() {
+        return ssGetJacobianPr(simStruct);
+    }
+
+    /** \ingroup statePort
+     * 
+     * Copies the nonzero values of a compressed sparse matrix having the 
+     * sparsity pattern of the Jacobian.
+     */
+    template<typename _Sparse>
+    inline void setJacobianValues(const _Sparse & values) {
+        if ((size_t) values.nonZeros() != jacobianRowIndices.size())
+            EASYLINK_RUNTIME_ERROR("The values do not have the sparsity pattern of the Jacobian.");
+        std::copy(values.valuePtr(), values.valuePtr() + values.nonZeros(), ssGetJacobianPr(simStruct));
+    }
+
+    /** \ingroup statePort
+     * 
+     * Computes the Jacobian by forward-mode automatic differentiation (see 
+     * Dual.h). The model is called as model(x, u, dx, y) with pointers to 
+     * the continuous states, the input elements (all ports), the state 
+     * derivatives and the output elements (all ports), of type
+     * Dual<double, _Lanes>:
+     * 
+     * \code{.cpp}
+     *     struct Model {
+     *         template<typename T>
+     *         void operator()(const T *x, const T *u, T *dx, T *y) const { ... }
+     *     };
+     * 
+     *     void jacobian() {
+     *         differentiateJacobian<4>(Model());
+     *     }
+     * \endcode
+     * 
+     * The columns of the sparsity pattern are colored so that columns without
+     * common nonzero rows share a lane: the model is evaluated once per 
+     * _Lanes colors. Only the elements of the pattern are written. Input ports
+     * must be of type double.
+     */
+    template<int _Lanes, typename _Model>
+    void differentiateJacobian(const _Model & model) {
+        typedef Dual<double, _Lanes> Scalar;
+        writeJacobianPattern();
+        int nx = ssGetNumContStates(simStruct);
+        int nRows = getJacobianNRows();
+        int nCols = getJacobianNCols();
+        if (jacobianColoring.getColsCount() != nCols)
+            jacobianColoring.compute(nRows, nCols, jacobianColumnStarts.data(), jacobianRowIndices.data());
+        if (jacobianWork.size() < (size_t) (nRows + nCols) * sizeof (Scalar))
+            jacobianWork.resize((size_t) (nRows + nCols) * sizeof (Scalar));
+        Scalar *in = (Scalar*) jacobianWork.data();
+        Scalar *out = in + nCols;
+
+        // Values of the states and the inputs
+        const double *x = ssGetContStates(simStruct);
+        for (int i = 0; i < nx; i++)
+            new (&in[i]) Scalar(x[i]);
+        int col = nx;
+        for (int port = 0; port < (int) inputPorts.size(); port++) {
+            if (inputPorts[port].type != SS_DOUBLE)
+                throw std::runtime_error("Unable to differentiate the block. " + inputPorts[port].name + " must be of type double.");
+            const double *u = (const double*) gatherInput(port);
+            for (int i = 0; i < inputPorts[port].width; i++, col++)
+                new (&in[col]) Scalar(u[i]);
+        }
+
+        // One evaluation per group of _Lanes colors
+        double *values = ssGetJacobianPr(simStruct);
+        for (int first = 0; first < jacobianColoring.getColorsCount(); first += _Lanes) {
+            for (int j = 0; j < nCols; j++)
+                in[j] = Scalar(in[j].value, jacobianColoring.getColor(j) - first);
+            for (int i = 0; i < nRows; i++)
+                new (&out[i]) Scalar();
+            model((const Scalar*) in, (const Scalar*) in + nx, out, out + nx);
+            for (int j = 0; j < nCols; j++) {
+                int lane = jacobianColoring.getColor(j) - first;
+                if (lane < 0 || lane >= _Lanes)
+                    continue;
+                for (int k = jacobianColumnStarts[j]; k < jacobianColumnStarts[j + 1]; k++)
+                    values[k] = out[jacobianRowIndices[k]].tangent[lane];
+            }
+        }
+    }
+
+    /** \ingroup statePort
+     * 
+     * Returns a map of the Jacobian (no data copy), for instance an 
+     * Eigen::Map (see EigenBridge.h). The pattern must be dense (see 
+     * setJacobianDense).
+     */
+    template<typename _Map>
+    inline _Map getJacobianMap() {
+        int nRows = getJacobianNRows();
+        int nCols = getJacobianNCols();
+        if (jacobianRowIndices.size() != (size_t) nRows * nCols || !isMapSizeValid<_Map>(nRows, nCols))
+            EASYLINK_RUNTIME_ERROR_RETURN("The Jacobian is not dense or does not have the dimensions of the map.", getInvalidMap<_Map>(nRows, nCols));
+        return _Map((typename _Map::PointerArgType) ssGetJacobianPr(simStruct), nRows, nCols);
+    }
+
     /** Get the current simulation time */
-    static inline time_T getSimulationTime() {
+    inline time_T getSimulationTime() {
         return ssGetT(simStruct);
     }
 
+    /** Get the stop time of the simulation */
+    inline time_T getStopTime() {
+        return ssGetTFinal(simStruct);
+    }
+
 
 
 };
 
-SimStruct *BaseBlock::simStruct = NULL;
-int BaseBlock::parameterPortsCount = 0;
-int BaseBlock::inputPortsCount = 0;
-int BaseBlock::outputPortsCount = 0;
 
 
+/** BlockMethods tells at compile time which optional runtime methods a block
+ * implements, i.e. which methods are not inherited from BaseBlock.
+ * 
+ * sfunDefinitions.h uses it to skip the methods that are not implemented
+ * and, in MEX files only, to unregister their callbacks. Each method is 
+ * selected by its signature, so a block may overload the name with other 
+ * helpers (for instance a private update(int)). */
+template<typename _Block>
+struct BlockMethods {
+
+    enum {
+        derivatives = static_cast<void (_Block::*)()>(&_Block::derivatives) != static_cast<void (_Block::*)()>(&BaseBlock::derivatives),
+        zeroCrossings = static_cast<void (_Block::*)()>(&_Block::zeroCrossings) != static_cast<void (_Block::*)()>(&BaseBlock::zeroCrossings),
+        update = static_cast<void (_Block::*)()>(&_Block::update) != static_cast<void (_Block::*)()>(&BaseBlock::update),
+        serializeState = static_cast<void (_Block::*)(SimStateBuffer &)>(&_Block::serializeState) != static_cast<void (_Block::*)(SimStateBuffer &)>(&BaseBlock::serializeState),
+        outputsForRate = static_cast<void (_Block::*)(int)>(&_Block::outputsForRate) != static_cast<void (_Block::*)(int)>(&BaseBlock::outputsForRate),
+        updateForRate = static_cast<void (_Block::*)(int)>(&_Block::updateForRate) != static_cast<void (_Block::*)(int)>(&BaseBlock::updateForRate),
+        outputsFrame = static_cast<void (_Block::*)()>(&_Block::outputsFrame) != static_cast<void (_Block::*)()>(&BaseBlock::outputsFrame),
+        jacobian = static_cast<void (_Block::*)()>(&_Block::jacobian) != static_cast<void (_Block::*)()>(&BaseBlock::jacobian),
+        updateModes = static_cast<void (_Block::*)()>(&_Block::updateModes) != static_cast<void (_Block::*)()>(&BaseBlock::updateModes),
+        timeOfNextHit = static_cast<double (_Block::*)()>(&_Block::timeOfNextHit) != static_cast<double (_Block::*)()>(&BaseBlock::timeOfNextHit)
+    };
+};
+
 #endif
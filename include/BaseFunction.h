@@ -13,6 +13,7 @@
 #define EASYLINK_BASEFUNCTION_H
 
 #include "Array.h"
+#include "ArrayBuilder.h"
 
 /** BaseFunction is the basis class for designing new C++ MEX functions.
  *
@@ -60,6 +61,27 @@ public:
         }
     }
 
+    /**
+     * This method allows to check the dimensions and the type of an input 
+     * port (right-side argument) holding a stack of pages, i.e. an 
+     * M-by-N-by-P array.
+     * 
+     * Use -1 to specify dynamically dimensioned intput arrays. A 2-D array is 
+     * a stack of one page.
+     */
+    static void checkInputPages(int port, int nRows, int nCols, int nPages, mxClassID type = mxDOUBLE_CLASS) {
+        checkInputPort(port, nRows, -1, type);
+        if (mxGetNumberOfDimensions(prhs[port]) > 3) {
+            throw std::runtime_error("Input argument " + toString(port) + " must have at most 3 dimensions.");
+        }
+        if (nCols > 0 && getInputPageNCols(port) != nCols) {
+            throw std::runtime_error("Input argument " + toString(port) + " must have " + toString(nCols) + " cols.");
+        }
+        if (nPages > 0 && getInputNPages(port) != nPages) {
+            throw std::runtime_error("Input argument " + toString(port) + " must have " + toString(nPages) + " pages.");
+        }
+    }
+
     /**
      * This is the first static method that is called within the MEX-Function.
      *
@@ -94,6 +116,38 @@ public:
         }
     }
 
+    /**
+     * This method allows to set the dimensions and the type of an output 
+     * port (left-side argument) holding a stack of pages (M-by-N-by-P array).
+     * 
+     * The pages are stored side by side, so getOutputArray returns an 
+     * M-by-(N*P) Array.
+     */
+    static void setOutputPages(int port, int nRows, int nCols, int nPages, mxClassID type = mxDOUBLE_CLASS) {
+        if (nRows > 0 && nCols > 0 && nPages > 0) {
+            mwSize dims[3];
+            dims[0] = nRows;
+            dims[1] = nCols;
+            dims[2] = nPages;
+            plhs[port] = mxCreateNumericArray(3, dims, type, mxREAL);
+        }
+    }
+
+    /**
+     * This method writes an array built with an ArrayBuilder to an output port 
+     * (left-side argument).
+     * 
+     * The output adopts the memory of the builder (no data copy), so this 
+     * method can be called in computeOutputs when the size of the output is 
+     * not known in advance. The builder is emptied.
+     */
+    template<typename _Scalar>
+    static void setOutputPort(int port, ArrayBuilder<_Scalar> & builder) {
+        if (port < 0 || port >= (nlhs > 0 ? nlhs : 1))
+            throw std::runtime_error("Output argument " + toString(port) + " does not exist.");
+        plhs[port] = builder.release();
+    }
+
     /**
      * This is the second static method that is called within the MEX-Function.
      *
@@ -174,6 +228,21 @@ public:
         return (void*) mxGetData(prhs[port]);
     }
 
+    /**
+     * Returns a map of an input port (right-side argument) without data copy,
+     * for instance an Eigen::Map (see EigenBridge.h).
+     * 
+     * The compile-time dimensions of the map must agree with the argument.
+     */
+    template<typename _Map>
+    static inline _Map getInputMap(int port) {
+        int nRows = getInputNRows(port);
+        int nCols = getInputNCols(port);
+        if (!isMapSizeValid<_Map>(nRows, nCols))
+            throw std::runtime_error("Input argument " + toString(port) + " does not have the dimensions of the map.");
+        return _Map((typename _Map::PointerArgType) getInputData(port), nRows, nCols);
+    }
+
     /**
      * Returns the number of elements of an input port (right-side argument).
      * 
@@ -200,6 +269,26 @@ public:
         return mxGetN(prhs[port]);
     }
 
+    /**
+     * Returns the number of cols of each page of an input port (right-side 
+     * argument). For a 2-D array, this is the number of cols.
+     */
+    static inline int getInputPageNCols(int port) {
+        return (int) mxGetDimensions(prhs[port])[1];
+    }
+
+    /**
+     * Returns the number of pages of an input port (right-side argument), 
+     * i.e. the product of the dimensions after the second one.
+     */
+    static inline int getInputNPages(int port) {
+        const mwSize *dims = mxGetDimensions(prhs[port]);
+        int nPages = 1;
+        for (mwSize i = 2; i < mxGetNumberOfDimensions(prhs[port]); i++)
+            nPages *= (int) dims[i];
+        return nPages;
+    }
+
     /**
      * Returns the number of output ports (left-side arguments).
      */
@@ -248,6 +337,21 @@ public:
         return mxGetData(plhs[port]);
     }
 
+    /**
+     * Returns a map of an output port (left-side argument) without data copy,
+     * for instance an Eigen::Map (see EigenBridge.h).
+     * 
+     * The compile-time dimensions of the map must agree with the argument.
+     */
+    template<typename _Map>
+    static inline _Map getOutputMap(int port) {
+        int nRows = getOutputNRows(port);
+        int nCols = getOutputNCols(port);
+        if (!isMapSizeValid<_Map>(nRows, nCols))
+            throw std::runtime_error("Output argument " + toString(port) + " does not have the dimensions of the map.");
+        return _Map((typename _Map::PointerArgType) getOutputData(port), nRows, nCols);
+    }
+
     /**
      * Returns the number of elements of an output port (left-side argument).
      * 
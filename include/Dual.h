@@ -0,0 +1,366 @@
+/*
+ * This file is part of EasyLink Library.
+ *
+ * Copyright (c) 2014 FEMTO-ST, ENSMM, UFC, CNRS.
+ *
+ * License: GNU General Public License 3
+ *
+ * Author: Guillaume J. Laurent
+ *
+ */
+
+#ifndef EASYLINK_DUAL_H
+#define EASYLINK_DUAL_H
+
+#include <cmath>
+#include <vector>
+
+/** Dual is a dual number for forward-mode automatic differentiation: a value
+ * and its derivatives (tangents) along _Lanes directions.
+ *
+ * A model written once as a template of its scalar type is evaluated with
+ * doubles to get its values and with dual numbers to get exact derivatives:
+ *
+ * \code{.cpp}
+ *     template<typename T>
+ *     void model(const T *x, const T *u, T *dx, T *y) {
+ *         dx[0] = x[1];
+ *         dx[1] = mu * (1 - x[0] * x[0]) * x[1] - sin(x[0]) + u[0];
+ *     }
+ * \endcode
+ *
+ * Math functions must be called without the std:: prefix (sin and not
+ * std::sin) so that the overloads of Dual are found. Dual can be used as the
+ * scalar type of Array and, with EigenBridge.h, of Eigen matrices. */
+template<typename _Scalar, int _Lanes = 1>
+class Dual {
+public:
+
+    typedef _Scalar Scalar;
+
+    /** Value. */
+    _Scalar value;
+
+    /** Derivatives along each lane. */
+    _Scalar tangent[_Lanes];
+
+    /** Construct a constant (zero tangents). */
+    Dual(_Scalar value = _Scalar(0)) {
+        this->value = value;
+        for (int i = 0; i < _Lanes; i++)
+            tangent[i] = _Scalar(0);
+    }
+
+    /** Construct a variable: its tangent is one along lane and zero along
+     * the other lanes. */
+    Dual(_Scalar value, int lane) {
+        this->value = value;
+        for (int i = 0; i < _Lanes; i++)
+            tangent[i] = _Scalar(i == lane);
+    }
+
+    Dual & operator+=(const Dual & b) {
+        value += b.value;
+        for (int i = 0; i < _Lanes; i++)
+            tangent[i] += b.tangent[i];
+        return *this;
+    }
+
+    Dual & operator-=(const Dual & b) {
+        value -= b.value;
+        for (int i = 0; i < _Lanes; i++)
+            tangent[i] -= b.tangent[i];
+        return *this;
+    }
+
+    Dual & operator*=(const Dual & b) {
+        for (int i = 0; i < _Lanes; i++)
+            tangent[i] = tangent[i] * b.value + value * b.tangent[i];
+        value *= b.value;
+        return *this;
+    }
+
+    Dual & operator/=(const Dual & b) {
+        _Scalar inverse = _Scalar(1) / b.value;
+        value *= inverse;
+        for (int i = 0; i < _Lanes; i++)
+            tangent[i] = (tangent[i] - value * b.tangent[i]) * inverse;
+        return *this;
+    }
+
+    Dual & operator+=(_Scalar b) {
+        value += b;
+        return *this;
+    }
+
+    Dual & operator-=(_Scalar b) {
+        value -= b;
+        return *this;
+    }
+
+    Dual & operator*=(_Scalar b) {
+        value *= b;
+        for (int i = 0; i < _Lanes; i++)
+            tangent[i] *= b;
+        return *this;
+    }
+
+    Dual & operator/=(_Scalar b) {
+        return *this *= _Scalar(1) / b;
+    }
+
+    Dual operator-() const {
+        Dual result(-value);
+        for (int i = 0; i < _Lanes; i++)
+            result.tangent[i] = -tangent[i];
+        return result;
+    }
+
+    Dual operator+() const {
+        return *this;
+    }
+};
+
+/** Returns the value of x without its tangents (x itself for a scalar). */
+template<typename _Scalar, int _Lanes>
+inline _Scalar getValue(const Dual<_Scalar, _Lanes> & x) {
+    return x.value;
+}
+
+inline double getValue(double x) {
+    return x;
+}
+
+inline float getValue(float x) {
+    return x;
+}
+
+// Arithmetic operators --------------------------------------------------------
+
+#define EASYLINK_DUAL_OPERATOR(OP) \
+template<typename _Scalar, int _Lanes> \
+inline Dual<_Scalar, _Lanes> operator OP(Dual<_Scalar, _Lanes> a, const Dual<_Scalar, _Lanes> & b) { \
+    return a OP##= b; \
+} \
+template<typename _Scalar, int _Lanes> \
+inline Dual<_Scalar, _Lanes> operator OP(Dual<_Scalar, _Lanes> a, typename Dual<_Scalar, _Lanes>::Scalar b) { \
+    return a OP##= b; \
+} \
+template<typename _Scalar, int _Lanes> \
+inline Dual<_Scalar, _Lanes> operator OP(typename Dual<_Scalar, _Lanes>::Scalar a, const Dual<_Scalar, _Lanes> & b) { \
+    return Dual<_Scalar, _Lanes>(a) OP##= b; \
+}
+
+EASYLINK_DUAL_OPERATOR(+)
+EASYLINK_DUAL_OPERATOR(-)
+EASYLINK_DUAL_OPERATOR(*)
+EASYLINK_DUAL_OPERATOR(/)
+
+#undef EASYLINK_DUAL_OPERATOR
+
+// Comparison operators (on values) --------------------------------------------
+
+#define EASYLINK_DUAL_COMPARISON(OP) \
+template<typename _Scalar, int _Lanes> \
+inline bool operator OP(const Dual<_Scalar, _Lanes> & a, const Dual<_Scalar, _Lanes> & b) { \
+    return a.value OP b.value; \
+} \
+template<typename _Scalar, int _Lanes> \
+inline bool operator OP(const Dual<_Scalar, _Lanes> & a, typename Dual<_Scalar, _Lanes>::Scalar b) { \
+    return a.value OP b; \
+} \
+template<typename _Scalar, int _Lanes> \
+inline bool operator OP(typename Dual<_Scalar, _Lanes>::Scalar a, const Dual<_Scalar, _Lanes> & b) { \
+    return a OP b.value; \
+}
+
+EASYLINK_DUAL_COMPARISON(==)
+EASYLINK_DUAL_COMPARISON(!=)
+EASYLINK_DUAL_COMPARISON(<)
+EASYLINK_DUAL_COMPARISON(<=)
+EASYLINK_DUAL_COMPARISON(>)
+EASYLINK_DUAL_COMPARISON(>=)
+
+#undef EASYLINK_DUAL_COMPARISON
+
+// Math functions --------------------------------------------------------------
+
+// Applies the chain rule: f(x) has the value fx and the derivative dfx.
+template<typename _Scalar, int _Lanes>
+inline Dual<_Scalar, _Lanes> chainDual(const Dual<_Scalar, _Lanes> & x, _Scalar fx, _Scalar dfx) {
+    Dual<_Scalar, _Lanes> result(fx);
+    for (int i = 0; i < _Lanes; i++)
+        result.tangent[i] = dfx * x.tangent[i];
+    return result;
+}
+
+template<typename _Scalar, int _Lanes>
+inline Dual<_Scalar, _Lanes> sin(const Dual<_Scalar, _Lanes> & x) {
+    return chainDual(x, std::sin(x.value), std::cos(x.value));
+}
+
+template<typename _Scalar, int _Lanes>
+inline Dual<_Scalar, _Lanes> cos(const Dual<_Scalar, _Lanes> & x) {
+    return chainDual(x, std::cos(x.value), -std::sin(x.value));
+}
+
+template<typename _Scalar, int _Lanes>
+inline Dual<_Scalar, _Lanes> tan(const Dual<_Scalar, _Lanes> & x) {
+    _Scalar t = std::tan(x.value);
+    return chainDual(x, t, _Scalar(1) + t * t);
+}
+
+template<typename _Scalar, int _Lanes>
+inline Dual<_Scalar, _Lanes> asin(const Dual<_Scalar, _Lanes> & x) {
+    return chainDual(x, std::asin(x.value), _Scalar(1) / std::sqrt(_Scalar(1) - x.value * x.value));
+}
+
+template<typename _Scalar, int _Lanes>
+inline Dual<_Scalar, _Lanes> acos(const Dual<_Scalar, _Lanes> & x) {
+    return chainDual(x, std::acos(x.value), _Scalar(-1) / std::sqrt(_Scalar(1) - x.value * x.value));
+}
+
+template<typename _Scalar, int _Lanes>
+inline Dual<_Scalar, _Lanes> atan(const Dual<_Scalar, _Lanes> & x) {
+    return chainDual(x, std::atan(x.value), _Scalar(1) / (_Scalar(1) + x.value * x.value));
+}
+
+template<typename _Scalar, int _Lanes>
+inline Dual<_Scalar, _Lanes> atan2(const Dual<_Scalar, _Lanes> & y, const Dual<_Scalar, _Lanes> & x) {
+    _Scalar inverse = _Scalar(1) / (x.value * x.value + y.value * y.value);
+    Dual<_Scalar, _Lanes> result(std::atan2(y.value, x.value));
+    for (int i = 0; i < _Lanes; i++)
+        result.tangent[i] = (x.value * y.tangent[i] - y.value * x.tangent[i]) * inverse;
+    return result;
+}
+
+template<typename _Scalar, int _Lanes>
+inline Dual<_Scalar, _Lanes> sinh(const Dual<_Scalar, _Lanes> & x) {
+    return chainDual(x, std::sinh(x.value), std::cosh(x.value));
+}
+
+template<typename _Scalar, int _Lanes>
+inline Dual<_Scalar, _Lanes> cosh(const Dual<_Scalar, _Lanes> & x) {
+    return chainDual(x, std::cosh(x.value), std::sinh(x.value));
+}
+
+template<typename _Scalar, int _Lanes>
+inline Dual<_Scalar, _Lanes> tanh(const Dual<_Scalar, _Lanes> & x) {
+    _Scalar t = std::tanh(x.value);
+    return chainDual(x, t, _Scalar(1) - t * t);
+}
+
+template<typename _Scalar, int _Lanes>
+inline Dual<_Scalar, _Lanes> exp(const Dual<_Scalar, _Lanes> & x) {
+    _Scalar e = std::exp(x.value);
+    return chainDual(x, e, e);
+}
+
+template<typename _Scalar, int _Lanes>
+inline Dual<_Scalar, _Lanes> log(const Dual<_Scalar, _Lanes> & x) {
+    return chainDual(x, std::log(x.value), _Scalar(1) / x.value);
+}
+
+template<typename _Scalar, int _Lanes>
+inline Dual<_Scalar, _Lanes> sqrt(const Dual<_Scalar, _Lanes> & x) {
+    _Scalar s = std::sqrt(x.value);
+    return chainDual(x, s, _Scalar(0.5) / s);
+}
+
+template<typename _Scalar, int _Lanes>
+inline Dual<_Scalar, _Lanes> abs(const Dual<_Scalar, _Lanes> & x) {
+    return x.value < _Scalar(0) ? -x : x;
+}
+
+template<typename _Scalar, int _Lanes>
+inline Dual<_Scalar, _Lanes> fabs(const Dual<_Scalar, _Lanes> & x) {
+    return abs(x);
+}
+
+template<typename _Scalar, int _Lanes>
+inline Dual<_Scalar, _Lanes> pow(const Dual<_Scalar, _Lanes> & x, typename Dual<_Scalar, _Lanes>::Scalar p) {
+    return chainDual(x, std::pow(x.value, p), p * std::pow(x.value, p - _Scalar(1)));
+}
+
+template<typename _Scalar, int _Lanes>
+inline Dual<_Scalar, _Lanes> pow(const Dual<_Scalar, _Lanes> & x, const Dual<_Scalar, _Lanes> & p) {
+    return exp(p * log(x));
+}
+
+/** JacobianColoring groups the columns of a sparse Jacobian that have no
+ * nonzero element in a common row (greedy coloring of the column
+ * intersection graph).
+ *
+ * Columns of the same color are differentiated together with a single lane of
+ * a dual number: a banded or block-diagonal Jacobian of any size needs only
+ * as many lanes as its bandwidth. */
+class JacobianColoring {
+public:
+
+    JacobianColoring() {
+        colorsCount = 0;
+    }
+
+    /** Colors the columns of the compressed column pattern of a nRows x nCols
+     * matrix. */
+    void compute(int nRows, int nCols, const int *columnStarts, const int *rowIndices) {
+        // Transposed pattern: columns of each row
+        std::vector<int> rowStarts(nRows + 1, 0);
+        for (int k = 0; k < columnStarts[nCols]; k++)
+            rowStarts[rowIndices[k] + 1]++;
+        for (int row = 0; row < nRows; row++)
+            rowStarts[row + 1] += rowStarts[row];
+        std::vector<int> columnIndices(columnStarts[nCols]);
+        std::vector<int> position(rowStarts.begin(), rowStarts.end() - 1);
+        for (int col = 0; col < nCols; col++)
+            for (int k = columnStarts[col]; k < columnStarts[col + 1]; k++)
+                columnIndices[position[rowIndices[k]]++] = col;
+
+        // Smallest color not used by a previous column sharing a row
+        colors.assign(nCols, -1);
+        colorsCount = 0;
+        std::vector<int> forbidden(nCols, -1);
+        for (int col = 0; col < nCols; col++) {
+            for (int k = columnStarts[col]; k < columnStarts[col + 1]; k++) {
+                int row = rowIndices[k];
+                for (int j = rowStarts[row]; j < rowStarts[row + 1]; j++)
+                    if (colors[columnIndices[j]] >= 0)
+                        forbidden[colors[columnIndices[j]]] = col;
+            }
+            int color = 0;
+            while (forbidden[color] == col)
+                color++;
+            colors[col] = color;
+            if (color >= colorsCount)
+                colorsCount = color + 1;
+        }
+    }
+
+    /** Forgets the coloring. */
+    inline void clear() {
+        colors.clear();
+        colorsCount = 0;
+    }
+
+    /** Returns the number of colored columns (zero if not computed). */
+    inline int getColsCount() {
+        return (int) colors.size();
+    }
+
+    /** Returns the number of colors. */
+    inline int getColorsCount() {
+        return colorsCount;
+    }
+
+    /** Returns the color of a column. */
+    inline int getColor(int col) {
+        return colors[col];
+    }
+
+private:
+
+    std::vector<int> colors;
+    int colorsCount;
+};
+
+#endif
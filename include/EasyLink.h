@@ -17,6 +17,7 @@
 \defgroup outputPort Output ports managing methods
 \defgroup parameterPort S-function parameters managing methods
 \defgroup statePort S-function state ports managing methods
+\defgroup workPort S-function work vectors managing methods
 \defgroup matlabArray Matlab variables managing methods
 \defgroup utils Miscellaneous functions on strings and numbers
 
@@ -128,8 +129,268 @@ Contact: Guillaume J. Laurent, https://gjlaurent.github.io/
     Array<double> parameter3 = getParameterArray<double>(3);
 \endcode
 
+Runtime getters read a copy of the parameters, refreshed when they are tuned.
+Derived quantities are recomputed in processParameters:
+
+\code{.cpp}
+    void processParameters() {
+        if (parameterChanged(0))
+            gain = 2.0 * getParameterDouble(0);
+    }
+\endcode
+
+### Initialization methods
+
+Initialization methods are static and receive the SimStruct of the block. 
+Runtime methods (start, outputs...) use the block instance.
+
+\code{.cpp}
+    static void initializeInputPortSizes(SimStruct *S) {
+        setInputPortsCount(S, 1);
+        setInputPort(S, 0, getParameterNRows(S, 0), 1, SS_DOUBLE);
+    }
+
+    // Allows multithreaded simulation if the block uses no static variable
+    static void initializeOptions(SimStruct *S) {
+        setRuntimeThreadSafe(S);
+    }
+\endcode
+
+### Port signatures
+
+\code{.cpp}
+    typedef PortList<InputPort<U, double, 3> > Inputs;
+    typedef PortList<OutputPort<Y, double, 3> > Outputs;
+    typedef PortList<ParameterPort<K, double, 1, 1, true> > Parameters;
+
+    class Block : public TypedBlock<Inputs, Outputs, Parameters> {
+        void outputs() {
+            PortAt<U, Inputs>::type::View u = in<U>();
+            PortAt<Y, Outputs>::type::View y = out<Y>();
+            double k = param<K>()[0];
+            ...
+
+    class Function : public TypedFunction<Inputs, Outputs> {
+\endcode
+
+### Frame-based ports
+
+\code{.cpp}
+    setInputPort(S, 0, -1, -1, SS_DOUBLE, true, PORT_FRAME_INHERITED);
+    setOutputPort(S, 0, -1, -1, SS_DOUBLE, PORT_FRAME_INHERITED);   // sized as the input frame
+
+    void outputsFrame() {   // called instead of outputs for frame inputs
+        int frameSize = getInputFrameSize(0);
+        int channels = getInputChannelsCount(0);
+        ...
+    }
+\endcode
+
+Only a PORT_FRAME_INHERITED input accepts both frame-based and sample-based 
+signals. A PORT_FRAME_INHERITED output is frame-based if any input is, once 
+the frame data of all the inputs are known.
+
+### Variable-size ports
+
+\code{.cpp}
+    setInputPort(S, 0, 100, 1, SS_DOUBLE, true, PORT_VARIABLE_SIZE);   // at most 100 elements
+    setOutputPort(S, 0, 100, 1, SS_DOUBLE, PORT_VARIABLE_SIZE);
+
+    int width = getInputWidth(0);       // current size of the input
+    setOutputCurrentSizes(0, count);    // current size of the output
+\endcode
+
+### Bus ports
+
+\code{.cpp}
+    setInputBusPort(S, 0, "LimitsBus");    // Simulink.Bus object name
+    setOutputBusPort(S, 0, "StatusBus");
+
+    assertInputBusLayout<LimitsBus>(0, {offsetof(LimitsBus, value), offsetof(LimitsBus, lower)});   // in start
+    const LimitsBus &in = getInputBus<LimitsBus>(0);
+    StatusBus &out = getOutputBus<StatusBus>(0);
+\endcode
+
+### Non-contiguous input ports
+
+\code{.cpp}
+    setInputPort(S, 0, -1, 1, SS_DOUBLE, true, PORT_NON_CONTIGUOUS);
+
+    InputPortView<double> u = getInputView<double>(0);   // no copy
+    double u2 = u[2];
+    const double *data = (const double*) gatherInput(0);   // contiguous copy
+\endcode
+
+### Buffer reuse
+
+\code{.cpp}
+    setInputPort(S, 0, -1, 1, SS_DOUBLE, true, PORT_REUSABLE | PORT_LOCAL);
+    setInPlacePair(S, 0, 0);   // output 0 may use the buffer of input 0
+
+    Array<double> y = getInPlaceArray<double>(0, 0);   // holds the input values
+    y *= 2.0;
+\endcode
+
+### Multi-rate blocks
+
+\code{.cpp}
+    static void initializeNumberSampleTimes(SimStruct *S) {
+        setSampleTimesCount(S, 2);
+    }
+
+    static void initializeSampleTimes(SimStruct *S) {
+        setSampleTime(S, 0, 1e-4);   // fastest rate first
+        setSampleTime(S, 1, 0.1);
+    }
+
+    void outputsForRate(int rate) {...}   // called for each rate with a hit
+    void updateForRate(int rate) {...}
+
+    RateTransitionBuffer<double> buffer;   // multitasking-safe exchange
+\endcode
+
+### Port-based and constant sample times
+
+Each port inherits the sample time of its signal. When all the inputs are
+constant, outputs is called once at initialization and Simulink folds the block
+out of the simulation loop (parameters must not be tunable):
+
+\code{.cpp}
+    static void initializeNumberSampleTimes(SimStruct *S) {
+        setPortBasedSampleTimes(S);     // setPortBasedSampleTimes(S, false) forbids constant
+    }
+\endcode
+
+initializeSampleTimes is not called for such a block. The default 
+setInputPortSampleTime propagates the fastest input sample time to the outputs.
+Override it for other rules.
+
+### Event-driven blocks
+
+A block with a variable sample time runs only at the times returned by
+timeOfNextHit:
+
+\code{.cpp}
+    static void initializeSampleTimes(SimStruct *S) {
+        setVariableSampleTime(S);
+    }
+
+    void outputs() {
+        while (events.isDue(getSimulationTime()))
+            setOutputDouble(Y, events.pop());
+    }
+
+    double timeOfNextHit() {
+        return events.getNextTime(getStopTime());
+    }
+
+    EventQueue<double> events;   // events.schedule(time, value)
+\endcode
+
+### Work vectors
+
+\code{.cpp}
+    static void initializeWorkVectors(SimStruct *S) {
+        setDWorksCount(S, 2);
+        setDWork(S, 0, 9, SS_DOUBLE, "A");
+        setDWork(S, 1, 3, SS_DOUBLE, "x", true);   // discrete state
+    }
+
+    MatrixMap<double> a = getDWorkMap<MatrixMap<double> >(0, 3);
+    Array<double> x = getDWorkArray<double>(1);
+\endcode
+
+### Operating points
+
+A block that implements serializeState saves its DWorks, its states and the
+members it serializes with the operating point (SimState) of the model:
+
+\code{.cpp}
+    void serializeState(SimStateBuffer &state) {
+        state.serialize(counter);   // scalar
+        state.serialize(buffer);    // Array, Eigen matrix or std::vector
+        state.serialize(events);    // EventQueue
+    }
+\endcode
+
+Otherwise, the compliance of the block is left unknown. A block whose whole
+state is in DWorks and states declares it in initializeOptions:
+
+\code{.cpp}
+    static void initializeOptions(SimStruct *S) {
+        ssSetSimStateCompliance(S, USE_DEFAULT_SIM_STATE);
+    }
+\endcode
+
+### Zero crossings and modes
+
+\code{.cpp}
+    static void initializeStatePortSizes(SimStruct *S) {
+        setModesCount(S, 1);
+        setZeroCrossingsCount(S, 1);
+    }
+
+    void updateModes() {                // major time steps only
+        setMode(0, getInputDouble(U) > limit);
+    }
+
+    void outputs() {
+        setOutputDouble(Y, getMode(0) ? limit : getInputDouble(U));
+    }
+
+    void zeroCrossings() {
+        setZeroCrossing(0, getInputDouble(U) - limit);
+    }
+\endcode
+
+### Jacobian
+
+Stiff solvers use the analytical Jacobian J = [dx'/dx dx'/du; dy/dx dy/du] of
+the block instead of finite differences:
+
+\code{.cpp}
+    static void initializeStatePortSizes(SimStruct *S) {
+        setContinuousStatesWidth(S, 2);
+        setJacobianNzMax(S, 4);
+    }
+
+    void start() {
+        setJacobianPattern(pattern);    // compressed Eigen::SparseMatrix
+        // or setJacobianMask(mask), setJacobianDense()
+    }
+
+    void jacobian() {
+        setJacobianValues(values);      // or getJacobianData(), getJacobianMap<...>()
+    }
+\endcode
+
+### Automatic differentiation
+
+A model written once as a template is evaluated with doubles in outputs and
+derivatives, and with dual numbers (Dual.h) to compute the Jacobian. Columns of
+the sparsity pattern without common rows share a lane of the dual numbers:
+
+\code{.cpp}
+    struct Model {
+        template<typename T>
+        void operator()(const T *x, const T *u, T *dx, T *y) const {
+            dx[0] = x[1];
+            dx[1] = -sin(x[0]) + u[0];   // sin and not std::sin
+            y[0] = x[0];
+        }
+    };
+
+    void jacobian() {
+        differentiateJacobian<4>(Model());   // 4 lanes per evaluation
+    }
+\endcode
+
 ### Arrays
 
+The MATLAB arrays (existMatlabArray, getMatlabArray, newMatlabArray, 
+callMatlab) access the MATLAB workspace and are only available in MEX files
+(MATLAB_MEX_FILE defined), not in the generated code of a model.
+
 \code{.cpp}
     if (existMatlabArray("test")) ...
 
@@ -147,6 +408,98 @@ Contact: Guillaume J. Laurent, https://gjlaurent.github.io/
     a.print();
 \endcode
 
+### Memory-mapped arrays
+
+\code{.cpp}
+    writeMappedArray("table.bin", a);
+
+    MappedArray<double> table;
+    table.open(getParameterString(0));
+    double x = table(2, 3);
+\endcode
+
+The file is mapped copy-on-write: modifying a MappedArray never changes the file.
+
+
+### Page-wise operations
+
+\code{.cpp}
+    // M-by-N-by-P inputs, the pages are stored side by side in the Arrays
+    checkInputPages(0, 3, 3, -1);
+    setOutputPages(0, 3, 3, getInputNPages(0));
+
+    Array<double> a = getInputArray<double>(0);
+    Array<double> x = getOutputArray<double>(0);
+    pageMultiply(a, b, c, nPages);
+    int singular = pageSolve(a, b, x, nPages);
+    singular = pageInverse(a, x, nPages);
+    int notPositive = pageCholesky(a, l, nPages);
+\endcode
+
+Stacks of more than PAGE_THREAD_MIN_PAGES pages are split across PAGE_THREADS
+threads (one per core by default). testPageKernels.m checks every page of a
+multi-threaded stack.
+
+
+### Eigen
+
+\code{.cpp}
+    #include "EigenBridge.h"
+
+    ConstMatrixMap<double, 3, 1> u = getInputMap<ConstMatrixMap<double, 3, 1> >(0);
+    MatrixMap<double> y = getOutputMap<MatrixMap<double> >(0);
+    MatrixMap<double> x = getContinuousStateMap<MatrixMap<double> >();
+    Eigen::MatrixXd a = getParameterMap<ConstMatrixMap<double> >(0);
+
+    MatrixMap<double> m = toEigenMatrix(array);
+    Array<double> b = toArray(a);
+\endcode
+
+
+### Allocation-free diagnostic mode
+
+Compile with the EASYLINK_NO_MALLOC flag to report the heap allocations made
+in outputs, derivatives, update, zeroCrossings and computeOutputs (add
+EASYLINK_NO_MALLOC_STRICT to stop with an error):
+
+\verbatim >>make sfunStateSpace.cpp '' -DEASYLINK_NO_MALLOC \endverbatim
+
+### Accelerated modes and code generation
+
+In Rapid Accelerator mode (and with Simulink Coder), EasyLink S-functions are
+compiled from their C++ source as non-inlined S-functions. rtwmakecfg.m adds
+the EasyLink folders to the build (copy it in the folder of your 
+S-functions). Numeric parameters reach the generated code as run-time 
+parameters.
+
+EasyLink does not generate TLC files: in normal Accelerator mode, Simulink 
+still calls the MEX file of the S-function.
+
+The MEX file unregisters the callbacks of the optional methods that the block
+does not implement (derivatives, zeroCrossings, update, jacobian). The 
+generated code registers and calls every callback: those of the methods that
+are not implemented return immediately.
+
+### Exception-free release profile
+
+Compile with the EASYLINK_EXCEPTION_FREE flag to call the runtime methods
+(outputs, derivatives, zeroCrossings, update, timeOfNextHit) without 
+try/catch and to set SS_OPTION_RUNTIME_EXCEPTION_FREE_CODE, so that Simulink 
+does not protect each call. The accessors then report their errors with 
+setErrorStatus and return a safe value (an empty port, zero or a map of a 
+zeroed buffer) instead of throwing. Array (element access, in-place 
+operators, reshape, assignment to a shared array) and the Eigen bridge 
+(toEigenMatrix, toAlignedEigenMatrix) do the same and their error is reported
+when the runtime method returns. Runtime methods must also report errors 
+with setErrorStatus and must not throw. jacobian is not part of the profile:
+it is still called with try/catch, like the initialization methods.
+
+The following headers still throw and must only be used in start, terminate 
+or the initialization methods: the constructor of Array from a mxArray, 
+ArrayBuilder.h, MappedArray.h, MatlabArray.h, PageKernels.h and SimState.h.
+
+\verbatim >>make sfunStateSpace.cpp '' -DEASYLINK_EXCEPTION_FREE \endverbatim
+
 
 \page pageExamples Examples
 
@@ -173,6 +526,33 @@ S-function advanced examples:
   - sfunTimesTwo.cpp show how to change the size of an output according to
     the size of a dynamically-sized input array.
 
+  - sfunTypedGain.cpp shows how to declare the ports and the parameters with
+    port lists (sizes and accessors checked at compile time).
+
+  - sfunMultiRate.cpp shows how to write a multi-rate block with a fast and a
+    slow rate exchanging data through a RateTransitionBuffer.
+
+  - sfunFrameGain.cpp shows how to process frame-based signals with 
+    outputsFrame.
+
+  - sfunVariableSize.cpp shows how to read and write variable-size signals.
+
+  - sfunBus.cpp shows how to map bus signals onto C++ structs.
+
+  - sfunSum.cpp shows how to read a non-contiguous input port without copy.
+
+  - sfunSaturation.cpp shows how to use modes and zero crossings to locate
+    discontinuities (checked by testSaturation.m).
+
+  - sfunPolynomial.cpp shows how to propagate port-based sample times, 
+    including constant ones (checked by testPolynomial.m).
+
+  - sfunScheduledEvents.cpp shows how to write an event-driven block with a
+    variable sample time and an EventQueue (checked by testScheduledEvents.m).
+
+  - sfunVanDerPol.cpp shows how to compute the Jacobian of a nonlinear model
+    by automatic differentiation (checked by testVanDerPol.m).
+
 S-function examples using Eigen:
 
   - sfunTimesTwoWithEigen.cpp same as sfunTimesTwo.cpp but using Eigen in place 
@@ -191,6 +571,20 @@ MEX-function example using Eigen:
   - mexArrayProductWithEigen.cpp same as mexArrayProduct.cpp but using Eigen 
     in place of built-in Array class.
 
+MEX-function advanced example:
+
+  - mexFindPeaks.cpp shows how to return an output whose size is not known
+    in advance with ArrayBuilder (no over-allocation and no data copy).
+
+  - mexPageSolve.cpp shows how to solve a stack of small linear systems
+    given as 3-D arrays with the page-wise operations.
+
+MEX-function utilities:
+
+  - mexWriteMappedArray.cpp writes a MATLAB array to a binary file that
+    blocks can map in memory with MappedArray (large tables and calibration
+    maps).
+
  */
 
 #ifndef EASYLINK_H
@@ -198,9 +592,9 @@ MEX-function example using Eigen:
 
 #define __CPP2011__
 
-#ifndef MATLAB_MEX_FILE
-#define MATLAB_MEX_FILE
-#endif
+// MATLAB_MEX_FILE is defined by mex when compiling for simulation. It is not
+// defined when the generated code of a model (Rapid Accelerator, Simulink 
+// Coder) compiles a S-function as a non-inlined S-function (see rtwmakecfg.m).
 
 #ifdef S_FUNCTION_NAME
 #ifndef S_FUNCTION_LEVEL
@@ -213,6 +607,14 @@ MEX-function example using Eigen:
 #include "BaseFunction.h"
 #endif
 
+#include "AllocationGuard.h"
 #include "MatlabArray.h"
+#include "MappedArray.h"
+#include "ArrayBuilder.h"
+#include "PageKernels.h"
+#include "PortSignature.h"
+#include "RateTransition.h"
+#include "Dual.h"
+#include "EventQueue.h"
 
 #endif
@@ -0,0 +1,187 @@
+/*
+ * This file is part of EasyLink Library.
+ *
+ * Copyright (c) 2014 FEMTO-ST, ENSMM, UFC, CNRS.
+ *
+ * License: GNU General Public License 3
+ *
+ * Author: Guillaume J. Laurent
+ *
+ */
+
+#ifndef EASYLINK_EIGENBRIDGE_H
+#define EASYLINK_EIGENBRIDGE_H
+
+#include "EasyLink.h"
+#include <Eigen/Dense>
+#include <deque>
+#include <type_traits>
+#include <vector>
+
+/** \defgroup eigen Eigen bridge
+ *
+ * Types and functions to access ports, parameters, states and Arrays as Eigen
+ * objects without data copy.
+ *
+ * Include EigenBridge.h after EasyLink.h. Ports are mapped using getInputMap,
+ * getOutputMap, getParameterMap, getContinuousStateMap, getDerivativeStateMap
+ * and getDiscreteStateMap with one of the map types below:
+ *
+ * \code{.cpp}
+ *     ConstMatrixMap<double, 3, 1> u = getInputMap<ConstMatrixMap<double, 3, 1> >(U);
+ *     MatrixMap<double> y = getOutputMap<MatrixMap<double> >(Y);
+ * \endcode
+ *
+ * When the dimensions are given at compile time, the map is fixed-size and
+ * Eigen unrolls the products of small matrices. The dimensions are checked
+ * against the port when the map is created.
+ */
+
+/** \ingroup eigen
+ * Eigen matrix mapping data of type _Scalar. Dimensions default to dynamic. */
+template<typename _Scalar, int _Rows = Eigen::Dynamic, int _Cols = Eigen::Dynamic>
+using MatrixMap = Eigen::Map<Eigen::Matrix<_Scalar, _Rows, _Cols> >;
+
+/** \ingroup eigen
+ * Read-only Eigen matrix mapping data of type _Scalar (for input ports and
+ * parameters). */
+template<typename _Scalar, int _Rows = Eigen::Dynamic, int _Cols = Eigen::Dynamic>
+using ConstMatrixMap = Eigen::Map<const Eigen::Matrix<_Scalar, _Rows, _Cols> >;
+
+/** \ingroup eigen
+ * Eigen array (element-wise operations) mapping data of type _Scalar. */
+template<typename _Scalar, int _Rows = Eigen::Dynamic, int _Cols = Eigen::Dynamic>
+using ArrayMap = Eigen::Map<Eigen::Array<_Scalar, _Rows, _Cols> >;
+
+/** \ingroup eigen
+ * Read-only Eigen array (element-wise operations) mapping data of type _Scalar. */
+template<typename _Scalar, int _Rows = Eigen::Dynamic, int _Cols = Eigen::Dynamic>
+using ConstArrayMap = Eigen::Map<const Eigen::Array<_Scalar, _Rows, _Cols> >;
+
+/** \ingroup eigen
+ * Eigen matrix mapping 16-byte aligned data (memory allocated by EasyLink). */
+template<typename _Scalar, int _Rows = Eigen::Dynamic, int _Cols = Eigen::Dynamic>
+using AlignedMatrixMap = Eigen::Map<Eigen::Matrix<_Scalar, _Rows, _Cols>, Eigen::Aligned16>;
+
+/** \ingroup eigen
+ * Eigen array mapping 16-byte aligned data (memory allocated by EasyLink). */
+template<typename _Scalar, int _Rows = Eigen::Dynamic, int _Cols = Eigen::Dynamic>
+using AlignedArrayMap = Eigen::Map<Eigen::Array<_Scalar, _Rows, _Cols>, Eigen::Aligned16>;
+
+// Returns a zeroed aligned buffer of size elements, mapped instead of an
+// Array in the exception-free profile. The buffers are kept until the thread
+// exits, so that the maps returned before remain valid.
+template<typename _Scalar>
+inline _Scalar* getInvalidEigenData(int size) {
+    static thread_local std::deque<std::vector<_Scalar, Eigen::aligned_allocator<_Scalar> > > buffers;
+    buffers.push_back(std::vector<_Scalar, Eigen::aligned_allocator<_Scalar> >(size > 0 ? (size_t) size : 1, _Scalar(0)));
+    return buffers.back().data();
+}
+
+/** \ingroup eigen
+ * Returns an Eigen matrix mapping an Array (no data copy). */
+template<typename _Scalar>
+inline MatrixMap<_Scalar> toEigenMatrix(Array<_Scalar> & array) {
+    return MatrixMap<_Scalar>(array.getData(), array.getNRows(), array.getNCols());
+}
+
+/** \ingroup eigen
+ * Returns a fixed-size Eigen matrix mapping an Array (no data copy).
+ * The dimensions of the Array must agree. */
+template<int _Rows, int _Cols, typename _Scalar>
+inline MatrixMap<_Scalar, _Rows, _Cols> toEigenMatrix(Array<_Scalar> & array) {
+    if (!isMapSizeValid<MatrixMap<_Scalar, _Rows, _Cols> >(array.getNRows(), array.getNCols())) {
+        int nRows = _Rows >= 0 ? _Rows : array.getNRows();
+        int nCols = _Cols >= 0 ? _Cols : array.getNCols();
+        EASYLINK_ERROR_RETURN(std::runtime_error, "Unable to map " + array.getName() + ". Array dimensions must agree.",
+                (MatrixMap<_Scalar, _Rows, _Cols>(getInvalidEigenData<_Scalar>(nRows * nCols), nRows, nCols)));
+    }
+    return MatrixMap<_Scalar, _Rows, _Cols>(array.getData(), array.getNRows(), array.getNCols());
+}
+
+/** \ingroup eigen
+ * Returns an Eigen array mapping an Array (no data copy). */
+template<typename _Scalar>
+inline ArrayMap<_Scalar> toEigenArray(Array<_Scalar> & array) {
+    return ArrayMap<_Scalar>(array.getData(), array.getNRows(), array.getNCols());
+}
+
+/** \ingroup eigen
+ * Returns an aligned Eigen matrix mapping an Array that owns its data
+ * (no data copy). Throws an exception if the data is not 16-byte aligned. */
+template<typename _Scalar>
+inline AlignedMatrixMap<_Scalar> toAlignedEigenMatrix(Array<_Scalar> & array) {
+    if (((size_t) array.getData()) % 16 != 0)
+        EASYLINK_ERROR_RETURN(std::runtime_error, "Unable to map " + array.getName() + ". Array data are not aligned.",
+                AlignedMatrixMap<_Scalar>(getInvalidEigenData<_Scalar>(array.getWidth()), array.getNRows(), array.getNCols()));
+    return AlignedMatrixMap<_Scalar>(array.getData(), array.getNRows(), array.getNCols());
+}
+
+/** \ingroup eigen
+ * Returns an Eigen matrix mapping a PortView (see PortSignature.h), fixed-size
+ * when the dimensions of the port are given at compile time. */
+template<typename _Scalar, int _Rows, int _Cols>
+inline Eigen::Map<typename std::conditional<std::is_const<_Scalar>::value,
+const Eigen::Matrix<typename std::remove_const<_Scalar>::type, _Rows, _Cols>,
+Eigen::Matrix<_Scalar, _Rows, _Cols> >::type> toEigenMatrix(const PortView<_Scalar, _Rows, _Cols> & view) {
+    typedef typename std::conditional<std::is_const<_Scalar>::value,
+            const Eigen::Matrix<typename std::remove_const<_Scalar>::type, _Rows, _Cols>,
+            Eigen::Matrix<_Scalar, _Rows, _Cols> >::type Matrix;
+    return Eigen::Map<Matrix>(view.getData(), view.getNRows(), view.getNCols());
+}
+
+/** \ingroup eigen
+ * Returns an Array sharing the data of an Eigen matrix or array
+ * (no data copy). */
+template<typename _Derived>
+inline Array<typename _Derived::Scalar> toArray(Eigen::PlainObjectBase<_Derived> & matrix, std::string name = "eigen matrix") {
+    return Array<typename _Derived::Scalar>(matrix.data(), (int) matrix.rows(), (int) matrix.cols(), name, true);
+}
+
+/** \ingroup eigen
+ * Returns an Array sharing the data of an Eigen map (no data copy). */
+template<typename _PlainObject, int _Options>
+inline Array<typename _PlainObject::Scalar> toArray(Eigen::Map<_PlainObject, _Options> & map, std::string name = "eigen map") {
+    return Array<typename _PlainObject::Scalar>(map.data(), (int) map.rows(), (int) map.cols(), name, true);
+}
+
+/** \ingroup eigen
+ * Dual numbers (see Dual.h) as scalars of Eigen matrices, mixed with their
+ * real scalar type:
+ *
+ * \code{.cpp}
+ *     Eigen::Matrix<Dual<double, 4>, 3, 1> dx = a * x;   // a is a double matrix
+ * \endcode */
+namespace Eigen {
+
+template<typename _Scalar, int _Lanes>
+struct NumTraits<Dual<_Scalar, _Lanes> > : NumTraits<_Scalar> {
+    typedef Dual<_Scalar, _Lanes> Real;
+    typedef Dual<_Scalar, _Lanes> NonInteger;
+    typedef Dual<_Scalar, _Lanes> Nested;
+    typedef Dual<_Scalar, _Lanes> Literal;
+
+    enum {
+        IsComplex = 0,
+        IsInteger = 0,
+        IsSigned = 1,
+        RequireInitialization = 1,
+        ReadCost = 1 + _Lanes,
+        AddCost = 1 + _Lanes,
+        MulCost = 1 + 2 * _Lanes
+    };
+};
+
+template<typename _Scalar, int _Lanes, typename _BinaryOp>
+struct ScalarBinaryOpTraits<Dual<_Scalar, _Lanes>, _Scalar, _BinaryOp> {
+    typedef Dual<_Scalar, _Lanes> ReturnType;
+};
+
+template<typename _Scalar, int _Lanes, typename _BinaryOp>
+struct ScalarBinaryOpTraits<_Scalar, Dual<_Scalar, _Lanes>, _BinaryOp> {
+    typedef Dual<_Scalar, _Lanes> ReturnType;
+};
+
+}
+
+#endif
@@ -0,0 +1,156 @@
+/*
+ * This file is part of EasyLink Library.
+ *
+ * Copyright (c) 2014 FEMTO-ST, ENSMM, UFC, CNRS.
+ *
+ * License: GNU General Public License 3
+ *
+ * Author: Guillaume J. Laurent
+ *
+ */
+
+#ifndef EASYLINK_EVENTQUEUE_H
+#define EASYLINK_EVENTQUEUE_H
+
+#include <algorithm>
+#include <stdexcept>
+#include <stdint.h>
+#include <vector>
+
+/** EventQueue stores the events of an event-driven block ordered by time.
+ *
+ * A block with a variable sample time (see setVariableSampleTime) schedules
+ * its events in the queue, processes the due events in outputs and returns
+ * the time of the next event in timeOfNextHit:
+ *
+ * \code{.cpp}
+ *     void outputs() {
+ *         while (events.isDue(getSimulationTime()))
+ *             setOutputDouble(Y, events.pop());
+ *     }
+ *
+ *     double timeOfNextHit() {
+ *         return events.getNextTime(getStopTime());
+ *     }
+ * \endcode
+ *
+ * Events scheduled at the same time are processed in the order they were
+ * scheduled. Reserve the capacity of the queue (in start) to avoid heap
+ * allocations during the simulation.
+ *
+ * getNext and pop throw an exception if the queue is empty. In the 
+ * exception-free profile (EASYLINK_EXCEPTION_FREE), they return a 
+ * default-constructed event instead: check isEmpty or isDue first. */
+template<typename _Event>
+class EventQueue {
+public:
+
+    /** Construct an empty queue. */
+    EventQueue() : none() {
+        sequence = 0;
+    }
+
+    /** Allocates memory for capacity events. */
+    inline void reserve(int capacity) {
+        heap.reserve(capacity);
+    }
+
+    /** Removes all the events. */
+    inline void clear() {
+        heap.clear();
+        sequence = 0;
+    }
+
+    /** Returns true if the queue has no event. */
+    inline bool isEmpty() const {
+        return heap.empty();
+    }
+
+    /** Returns the number of events. */
+    inline int getSize() const {
+        return (int) heap.size();
+    }
+
+    /** Adds an event at a given time. */
+    void schedule(double time, const _Event & event) {
+        Entry entry;
+        entry.time = time;
+        entry.sequence = sequence++;
+        entry.event = event;
+        heap.push_back(entry);
+        std::push_heap(heap.begin(), heap.end(), Later());
+    }
+
+    /** Returns the time of the next event, or defaultTime if the queue is
+     * empty. */
+    inline double getNextTime(double defaultTime) const {
+        return heap.empty() ? defaultTime : heap.front().time;
+    }
+
+    /** Returns true if the next event is scheduled before or at time. */
+    inline bool isDue(double time) const {
+        return !heap.empty() && heap.front().time <= time;
+    }
+
+    /** Returns the next event. */
+    inline const _Event & getNext() const {
+        if (heap.empty())
+#ifdef EASYLINK_EXCEPTION_FREE
+            return none;
+#else
+            throw std::runtime_error("The event queue is empty.");
+#endif
+        return heap.front().event;
+    }
+
+    /** Removes the next event and returns it. */
+    _Event pop() {
+        if (heap.empty())
+#ifdef EASYLINK_EXCEPTION_FREE
+            return none;
+#else
+            throw std::runtime_error("The event queue is empty.");
+#endif
+        std::pop_heap(heap.begin(), heap.end(), Later());
+        _Event event = heap.back().event;
+        heap.pop_back();
+        return event;
+    }
+
+    /** Saves or restores the events, in the operating point of a block (see
+     * SimStateBuffer). The events must be serializable by the buffer. */
+    template<typename _Buffer>
+    void serialize(_Buffer & state) {
+        uint64_t size = (uint64_t) heap.size();
+        state.serialize(size);
+        if (state.isReading())
+            heap.resize((size_t) size);
+        state.serialize(sequence);
+        for (size_t i = 0; i < heap.size(); i++) {
+            state.serialize(heap[i].time);
+            state.serialize(heap[i].sequence);
+            state.serialize(heap[i].event);
+        }
+    }
+
+private:
+
+    struct Entry {
+        double time;
+        unsigned long long sequence;
+        _Event event;
+    };
+
+    // Orders the heap with the earliest event first
+    struct Later {
+        bool operator()(const Entry & a, const Entry & b) const {
+            return a.time > b.time || (a.time == b.time && a.sequence > b.sequence);
+        }
+    };
+
+    std::vector<Entry> heap;
+    unsigned long long sequence;
+    _Event none; // returned by an empty queue in the exception-free profile
+};
+
+#endif
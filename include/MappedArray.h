@@ -0,0 +1,232 @@
+/*
+ * This file is part of EasyLink Library.
+ *
+ * Copyright (c) 2014 FEMTO-ST, ENSMM, UFC, CNRS.
+ *
+ * License: GNU General Public License 3
+ *
+ * Author: Guillaume J. Laurent
+ *
+ */
+
+#ifndef EASYLINK_MAPPEDARRAY_H
+#define EASYLINK_MAPPEDARRAY_H
+
+#include "Array.h"
+#include <stdio.h>
+#include <stdint.h>
+
+#ifdef _WIN32
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#define MAPPED_ARRAY_MAGIC "EASYLINK"
+#define MAPPED_ARRAY_VERSION 1
+#define MAPPED_ARRAY_DATA_OFFSET 64
+
+/** Header stored at the beginning of a mapped array file.
+ *
+ * The data follow the header at offset MAPPED_ARRAY_DATA_OFFSET in
+ * column-major order (MATLAB order). */
+struct MappedArrayHeader {
+    char magic[8];
+    int32_t version;
+    int32_t classID;
+    int32_t elementSize;
+    int32_t nrows;
+    int32_t ncols;
+    int32_t reserved;
+    int64_t dataOffset;
+};
+
+/** MappedArray is an Array backed by a memory-mapped binary file.
+ *
+ * The file is mapped copy-on-write: the pages are loaded lazily on first
+ * access and the physical memory is shared by all the blocks and processes
+ * mapping the same file. A MappedArray can be passed anywhere an Array
+ * reference is expected. Modifying an element copies its page privately:
+ * the change is only seen by this array and is never written to the file.
+ *
+ * Files are produced with writeMappedArray (see also mexWriteMappedArray.cpp).
+ */
+template<typename _Scalar>
+class MappedArray : public Array<_Scalar> {
+public:
+
+    /** Default constructor. The array is empty until open is called. */
+    MappedArray(std::string name = "untitled mapped array") : Array<_Scalar>(name) {
+        mapping = NULL;
+        mappingSize = 0;
+#ifdef _WIN32
+        fileHandle = INVALID_HANDLE_VALUE;
+        mappingHandle = NULL;
+#endif
+    }
+
+    /** Construct an Array mapping the given file. */
+    MappedArray(std::string filename, std::string name) : Array<_Scalar>(name) {
+        mapping = NULL;
+        mappingSize = 0;
+#ifdef _WIN32
+        fileHandle = INVALID_HANDLE_VALUE;
+        mappingHandle = NULL;
+#endif
+        open(filename);
+    }
+
+    /** Destructor. Unmap the file. */
+    ~MappedArray() {
+        close();
+    }
+
+    /** Map a file produced by writeMappedArray.
+     *
+     * Throws an exception if the file cannot be mapped or if its type does
+     * not match _Scalar. */
+    void open(std::string filename) {
+        close();
+
+#ifdef _WIN32
+        fileHandle = CreateFileA(filename.c_str(), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+        if (fileHandle == INVALID_HANDLE_VALUE)
+            throw std::runtime_error("Unable to open mapped array file " + filename + ".");
+        LARGE_INTEGER size;
+        GetFileSizeEx(fileHandle, &size);
+        mappingSize = (size_t) size.QuadPart;
+        if (mappingSize < sizeof (MappedArrayHeader)) {
+            close();
+            throw std::runtime_error("File " + filename + " is not a mapped array file.");
+        }
+        mappingHandle = CreateFileMappingA(fileHandle, NULL, PAGE_WRITECOPY, 0, 0, NULL);
+        if (mappingHandle != NULL)
+            mapping = MapViewOfFile(mappingHandle, FILE_MAP_COPY, 0, 0, 0);
+        if (mapping == NULL) {
+            close();
+            throw std::runtime_error("Unable to map file " + filename + ".");
+        }
+#else
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd < 0)
+            throw std::runtime_error("Unable to open mapped array file " + filename + ".");
+        struct stat status;
+        if (fstat(fd, &status) != 0 || (size_t) status.st_size < sizeof (MappedArrayHeader)) {
+            ::close(fd);
+            throw std::runtime_error("File " + filename + " is not a mapped array file.");
+        }
+        mappingSize = (size_t) status.st_size;
+        mapping = mmap(NULL, mappingSize, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (mapping == MAP_FAILED) {
+            mapping = NULL;
+            mappingSize = 0;
+            throw std::runtime_error("Unable to map file " + filename + ".");
+        }
+#endif
+
+        const MappedArrayHeader *header = (const MappedArrayHeader*) mapping;
+        std::string error;
+        if (memcmp(header->magic, MAPPED_ARRAY_MAGIC, 8) != 0 || header->version != MAPPED_ARRAY_VERSION)
+            error = "File " + filename + " is not a mapped array file.";
+        else if (header->classID != ScalarClassID<_Scalar>::value || header->elementSize != sizeof (_Scalar))
+            error = "Mapped array file " + filename + " has a wrong type.";
+        else if (header->nrows < 0 || header->ncols < 0 || header->dataOffset < (int64_t) sizeof (MappedArrayHeader)
+                || (size_t) header->dataOffset + (size_t) header->nrows * header->ncols * sizeof (_Scalar) > mappingSize)
+            error = "Mapped array file " + filename + " is truncated.";
+        if (!error.empty()) {
+            close();
+            throw std::runtime_error(error);
+        }
+
+        this->nrows = header->nrows;
+        this->ncols = header->ncols;
+        this->data = (_Scalar*) ((char*) mapping + header->dataOffset);
+        this->mxarray = NULL;
+        this->moveable = false;
+        this->releaseData = false;
+    }
+
+    /** Unmap the file and empty the array. */
+    void close() {
+        this->empty();
+#ifdef _WIN32
+        if (mapping != NULL)
+            UnmapViewOfFile(mapping);
+        if (mappingHandle != NULL)
+            CloseHandle(mappingHandle);
+        if (fileHandle != INVALID_HANDLE_VALUE)
+            CloseHandle(fileHandle);
+        mappingHandle = NULL;
+        fileHandle = INVALID_HANDLE_VALUE;
+#else
+        if (mapping != NULL)
+            munmap(mapping, mappingSize);
+#endif
+        mapping = NULL;
+        mappingSize = 0;
+    }
+
+    /** Returns true if a file is currently mapped. */
+    bool isOpen() {
+        return mapping != NULL;
+    }
+
+private:
+
+    void *mapping;
+    size_t mappingSize;
+#ifdef _WIN32
+    HANDLE fileHandle;
+    HANDLE mappingHandle;
+#endif
+
+    // A mapping cannot be duplicated, use an Array copy instead.
+    MappedArray(const MappedArray<_Scalar> &);
+    MappedArray<_Scalar>& operator=(const MappedArray<_Scalar> &);
+};
+
+/** \ingroup matlabArray
+ * Writes raw column-major data to a file readable by MappedArray.
+ *
+ * Throws an exception if the file cannot be written. */
+inline void writeMappedArray(std::string filename, const void *data, int nrows, int ncols, mxClassID type, size_t elementSize) {
+    MappedArrayHeader header;
+    char padding[MAPPED_ARRAY_DATA_OFFSET];
+
+    memset((void*) &header, 0, sizeof (header));
+    memcpy(header.magic, MAPPED_ARRAY_MAGIC, 8);
+    header.version = MAPPED_ARRAY_VERSION;
+    header.classID = (int32_t) type;
+    header.elementSize = (int32_t) elementSize;
+    header.nrows = nrows;
+    header.ncols = ncols;
+    header.dataOffset = MAPPED_ARRAY_DATA_OFFSET;
+    memset(padding, 0, sizeof (padding));
+    memcpy(padding, &header, sizeof (header));
+
+    FILE *file = fopen(filename.c_str(), "wb");
+    if (file == NULL)
+        throw std::runtime_error("Unable to create mapped array file " + filename + ".");
+
+    size_t size = (size_t) nrows * ncols * elementSize;
+    bool written = fwrite(padding, 1, MAPPED_ARRAY_DATA_OFFSET, file) == MAPPED_ARRAY_DATA_OFFSET
+            && (size == 0 || fwrite(data, 1, size, file) == size);
+    if (fclose(file) != 0 || !written)
+        throw std::runtime_error("Unable to write mapped array file " + filename + ".");
+}
+
+/** \ingroup matlabArray
+ * Writes an Array to a file readable by MappedArray. */
+template<typename _Scalar>
+void writeMappedArray(std::string filename, Array<_Scalar> & array) {
+    writeMappedArray(filename, (const void*) array.getData(), array.getNRows(), array.getNCols(), ScalarClassID<_Scalar>::value, sizeof (_Scalar));
+}
+
+#endif
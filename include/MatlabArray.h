@@ -14,6 +14,10 @@
 
 #include "Array.h"
 
+// The MATLAB workspace is only reachable from a MEX file: the generated code
+// of a model (MATLAB_MEX_FILE undefined) has no MATLAB arrays.
+#ifdef MATLAB_MEX_FILE
+
 /** \ingroup matlabArray
  * Returns an Array connected to a MATLAB variable in a given workspace.
  * Works only with double array.
@@ -106,4 +110,6 @@ Array<_Scalar> callMatlab(std::string cmd, Array<_Scalar> & operand1, Array<_Sca
     return result;
 }
 
+#endif // MATLAB_MEX_FILE
+
 #endif
@@ -0,0 +1,372 @@
+/*
+ * This file is part of EasyLink Library.
+ *
+ * Copyright (c) 2014 FEMTO-ST, ENSMM, UFC, CNRS.
+ *
+ * License: GNU General Public License 3
+ *
+ * Author: Guillaume J. Laurent
+ *
+ */
+
+#ifndef EASYLINK_PAGEKERNELS_H
+#define EASYLINK_PAGEKERNELS_H
+
+#include "Array.h"
+#include <vector>
+#include <thread>
+#include <exception>
+#include <algorithm>
+#include <math.h>
+
+/** \defgroup pages Page-wise small-matrix operations
+ *
+ * Batched operations on stacks of small matrices stored as M-by-N-by-P arrays
+ * (P pages of M-by-N matrices, MATLAB order).
+ *
+ * Pages are processed by groups of PAGE_LANES: each group is transposed in a
+ * structure-of-arrays layout so that every arithmetic operation is applied to
+ * PAGE_LANES pages at once and vectorized by the compiler. Stacks of more than
+ * PAGE_THREAD_MIN_PAGES pages are split across threads.
+ *
+ * In an Array, the pages are stored side by side: a stack of P M-by-N pages
+ * is an M-by-(N*P) Array, as given by a MATLAB M-by-N-by-P array.
+ */
+
+#ifndef PAGE_LANES
+#define PAGE_LANES 8
+#endif
+
+#ifndef PAGE_THREAD_MIN_PAGES
+#define PAGE_THREAD_MIN_PAGES 8192
+#endif
+
+// Number of threads (0 uses one thread per core)
+#ifndef PAGE_THREADS
+#define PAGE_THREADS 0
+#endif
+
+/** \ingroup pages
+ * PageKernels implements the page-wise operations on raw data.
+ *
+ * All the pointers address P contiguous column-major pages. The methods
+ * returning an int return the number of singular (or not positive definite)
+ * pages, whose results are filled with NaN or Inf values. */
+template<typename _Scalar>
+class PageKernels {
+public:
+
+    /** C(:,:,p) = A(:,:,p) * B(:,:,p) where A is M-by-K and B is K-by-N. */
+    static void multiply(const _Scalar *a, const _Scalar *b, _Scalar *c, int m, int k, int n, int nPages) {
+        run(nPages, [ = ](int first, int last) -> int {
+            std::vector<_Scalar> buffer((size_t) (m * k + k * n + m * n) * PAGE_LANES);
+            _Scalar *pa = &buffer[0];
+            _Scalar *pb = pa + m * k * PAGE_LANES;
+            _Scalar *pc = pb + k * n * PAGE_LANES;
+            for (int page = first; page < last; page += PAGE_LANES) {
+                int lanes = std::min(PAGE_LANES, last - page);
+                pack(a, m * k, page, lanes, pa);
+                pack(b, k * n, page, lanes, pb);
+                multiplyLanes(pa, pb, pc, m, k, n);
+                unpack(pc, m * n, page, lanes, c);
+            }
+            return 0;
+        });
+    }
+
+    /** X(:,:,p) = A(:,:,p) \ B(:,:,p) where A is N-by-N and B is N-by-R.
+     * Gauss-Jordan elimination with partial pivoting. */
+    static int solve(const _Scalar *a, const _Scalar *b, _Scalar *x, int n, int r, int nPages) {
+        return run(nPages, [ = ](int first, int last) -> int {
+            std::vector<_Scalar> buffer((size_t) (n * n + n * r) * PAGE_LANES);
+            _Scalar *pa = &buffer[0];
+            _Scalar *pb = pa + n * n * PAGE_LANES;
+            int singular = 0;
+            for (int page = first; page < last; page += PAGE_LANES) {
+                int lanes = std::min(PAGE_LANES, last - page);
+                pack(a, n * n, page, lanes, pa);
+                pack(b, n * r, page, lanes, pb);
+                singular += solveLanes(pa, pb, n, r, lanes);
+                unpack(pb, n * r, page, lanes, x);
+            }
+            return singular;
+        });
+    }
+
+    /** X(:,:,p) = inv(A(:,:,p)) where A is N-by-N. */
+    static int inverse(const _Scalar *a, _Scalar *x, int n, int nPages) {
+        return run(nPages, [ = ](int first, int last) -> int {
+            std::vector<_Scalar> buffer((size_t) (2 * n * n) * PAGE_LANES);
+            _Scalar *pa = &buffer[0];
+            _Scalar *pb = pa + n * n * PAGE_LANES;
+            int singular = 0;
+            for (int page = first; page < last; page += PAGE_LANES) {
+                int lanes = std::min(PAGE_LANES, last - page);
+                pack(a, n * n, page, lanes, pa);
+                for (int i = 0; i < n * n; i++)
+                    for (int w = 0; w < PAGE_LANES; w++)
+                        pb[i * PAGE_LANES + w] = (i % (n + 1) == 0) ? 1 : 0;
+                singular += solveLanes(pa, pb, n, n, lanes);
+                unpack(pb, n * n, page, lanes, x);
+            }
+            return singular;
+        });
+    }
+
+    /** L(:,:,p) = chol(A(:,:,p), 'lower') where A is N-by-N symmetric positive
+     * definite. Only the lower triangle of A is read. */
+    static int cholesky(const _Scalar *a, _Scalar *l, int n, int nPages) {
+        return run(nPages, [ = ](int first, int last) -> int {
+            std::vector<_Scalar> buffer((size_t) (n * n) * PAGE_LANES);
+            _Scalar *pa = &buffer[0];
+            int notPositive = 0;
+            for (int page = first; page < last; page += PAGE_LANES) {
+                int lanes = std::min(PAGE_LANES, last - page);
+                pack(a, n * n, page, lanes, pa);
+                notPositive += choleskyLanes(pa, n, lanes);
+                unpack(pa, n * n, page, lanes, l);
+            }
+            return notPositive;
+        });
+    }
+
+private:
+
+    // Splits the pages across threads and sums the results of each thread.
+    template<typename F>
+    static int run(int nPages, F kernel) {
+        int nThreads = PAGE_THREADS > 0 ? PAGE_THREADS : (int) std::thread::hardware_concurrency();
+        if (nThreads > nPages / PAGE_THREAD_MIN_PAGES)
+            nThreads = nPages / PAGE_THREAD_MIN_PAGES;
+        if (nThreads <= 1)
+            return kernel(0, nPages);
+
+        // Chunks are multiples of PAGE_LANES pages, the last one ends at nPages
+        int chunk = ((nPages + nThreads - 1) / nThreads + PAGE_LANES - 1) / PAGE_LANES * PAGE_LANES;
+        std::vector<std::thread> threads;
+        std::vector<int> results(nThreads, 0);
+        std::vector<std::exception_ptr> errors(nThreads);
+        for (int t = 1; t < nThreads; t++) {
+            int first = std::min(t * chunk, nPages);
+            int last = (t == nThreads - 1) ? nPages : std::min(first + chunk, nPages);
+            threads.push_back(std::thread([&results, &errors, &kernel, t, first, last]() {
+                try {
+                    results[t] = kernel(first, last);
+                } catch (...) {
+                    errors[t] = std::current_exception();
+                }
+            }));
+        }
+        try {
+            results[0] = kernel(0, std::min(chunk, nPages));
+        } catch (...) {
+            errors[0] = std::current_exception();
+        }
+
+        // All the threads are joined before an error is reported
+        for (size_t t = 0; t < threads.size(); t++)
+            threads[t].join();
+        int total = 0;
+        for (int t = 0; t < nThreads; t++) {
+            if (errors[t])
+                std::rethrow_exception(errors[t]);
+            total += results[t];
+        }
+        return total;
+    }
+
+    // Transposes lanes pages of size elements into the lane-major layout.
+    // Missing lanes repeat the last page to keep the arithmetic well defined.
+    static inline void pack(const _Scalar *src, int size, int page, int lanes, _Scalar *dst) {
+        for (int w = 0; w < PAGE_LANES; w++) {
+            const _Scalar *p = src + (size_t) (page + std::min(w, lanes - 1)) * size;
+            for (int e = 0; e < size; e++)
+                dst[e * PAGE_LANES + w] = p[e];
+        }
+    }
+
+    static inline void unpack(const _Scalar *src, int size, int page, int lanes, _Scalar *dst) {
+        for (int w = 0; w < lanes; w++) {
+            _Scalar *p = dst + (size_t) (page + w) * size;
+            for (int e = 0; e < size; e++)
+                p[e] = src[e * PAGE_LANES + w];
+        }
+    }
+
+    static inline void multiplyLanes(const _Scalar *a, const _Scalar *b, _Scalar *c, int m, int k, int n) {
+        for (int j = 0; j < n; j++) {
+            for (int i = 0; i < m; i++) {
+                _Scalar *pc = c + (i + j * m) * PAGE_LANES;
+                for (int w = 0; w < PAGE_LANES; w++)
+                    pc[w] = 0;
+                for (int l = 0; l < k; l++) {
+                    const _Scalar *pa = a + (i + l * m) * PAGE_LANES;
+                    const _Scalar *pb = b + (l + j * k) * PAGE_LANES;
+                    for (int w = 0; w < PAGE_LANES; w++)
+                        pc[w] += pa[w] * pb[w];
+                }
+            }
+        }
+    }
+
+    // Gauss-Jordan elimination of [A | B], B is replaced by A \ B.
+    static int solveLanes(_Scalar *a, _Scalar *b, int n, int r, int lanes) {
+        _Scalar best[PAGE_LANES], pivot[PAGE_LANES], factor[PAGE_LANES];
+        int row[PAGE_LANES];
+        int singular = 0;
+
+        for (int k = 0; k < n; k++) {
+            // Partial pivoting, independently in each lane
+            _Scalar *akk = a + (k + k * n) * PAGE_LANES;
+            for (int w = 0; w < PAGE_LANES; w++) {
+                best[w] = fabs(akk[w]);
+                row[w] = k;
+            }
+            for (int i = k + 1; i < n; i++) {
+                _Scalar *aik = a + (i + k * n) * PAGE_LANES;
+                for (int w = 0; w < PAGE_LANES; w++) {
+                    _Scalar v = fabs(aik[w]);
+                    bool greater = v > best[w];
+                    best[w] = greater ? v : best[w];
+                    row[w] = greater ? i : row[w];
+                }
+            }
+            for (int w = 0; w < PAGE_LANES; w++) {
+                int i = row[w];
+                if (i != k) {
+                    for (int j = k; j < n; j++)
+                        std::swap(a[(k + j * n) * PAGE_LANES + w], a[(i + j * n) * PAGE_LANES + w]);
+                    for (int j = 0; j < r; j++)
+                        std::swap(b[(k + j * n) * PAGE_LANES + w], b[(i + j * n) * PAGE_LANES + w]);
+                }
+                if (best[w] == 0 && w < lanes)
+                    singular++;
+            }
+
+            // Normalization of the pivot row
+            for (int w = 0; w < PAGE_LANES; w++)
+                pivot[w] = 1 / akk[w];
+            for (int j = k; j < n; j++) {
+                _Scalar *akj = a + (k + j * n) * PAGE_LANES;
+                for (int w = 0; w < PAGE_LANES; w++)
+                    akj[w] *= pivot[w];
+            }
+            for (int j = 0; j < r; j++) {
+                _Scalar *bkj = b + (k + j * n) * PAGE_LANES;
+                for (int w = 0; w < PAGE_LANES; w++)
+                    bkj[w] *= pivot[w];
+            }
+
+            // Elimination in the other rows
+            for (int i = 0; i < n; i++) {
+                if (i == k)
+                    continue;
+                _Scalar *aik = a + (i + k * n) * PAGE_LANES;
+                for (int w = 0; w < PAGE_LANES; w++)
+                    factor[w] = aik[w];
+                for (int j = k; j < n; j++) {
+                    _Scalar *aij = a + (i + j * n) * PAGE_LANES;
+                    const _Scalar *akj = a + (k + j * n) * PAGE_LANES;
+                    for (int w = 0; w < PAGE_LANES; w++)
+                        aij[w] -= factor[w] * akj[w];
+                }
+                for (int j = 0; j < r; j++) {
+                    _Scalar *bij = b + (i + j * n) * PAGE_LANES;
+                    const _Scalar *bkj = b + (k + j * n) * PAGE_LANES;
+                    for (int w = 0; w < PAGE_LANES; w++)
+                        bij[w] -= factor[w] * bkj[w];
+                }
+            }
+        }
+        return singular;
+    }
+
+    // In-place Cholesky factorization, the upper triangle is set to zero.
+    static int choleskyLanes(_Scalar *a, int n, int lanes) {
+        int notPositive = 0;
+        for (int j = 0; j < n; j++) {
+            _Scalar *ajj = a + (j + j * n) * PAGE_LANES;
+            for (int l = 0; l < j; l++) {
+                const _Scalar *ajl = a + (j + l * n) * PAGE_LANES;
+                for (int w = 0; w < PAGE_LANES; w++)
+                    ajj[w] -= ajl[w] * ajl[w];
+            }
+            for (int w = 0; w < PAGE_LANES; w++) {
+                if (!(ajj[w] > 0) && w < lanes)
+                    notPositive++;
+                ajj[w] = sqrt(ajj[w]);
+            }
+            for (int i = j + 1; i < n; i++) {
+                _Scalar *aij = a + (i + j * n) * PAGE_LANES;
+                for (int l = 0; l < j; l++) {
+                    const _Scalar *ail = a + (i + l * n) * PAGE_LANES;
+                    const _Scalar *ajl = a + (j + l * n) * PAGE_LANES;
+                    for (int w = 0; w < PAGE_LANES; w++)
+                        aij[w] -= ail[w] * ajl[w];
+                }
+                for (int w = 0; w < PAGE_LANES; w++)
+                    aij[w] /= ajj[w];
+            }
+            for (int i = 0; i < j; i++) {
+                _Scalar *aij = a + (i + j * n) * PAGE_LANES;
+                for (int w = 0; w < PAGE_LANES; w++)
+                    aij[w] = 0;
+            }
+        }
+        return notPositive;
+    }
+};
+
+/** \ingroup pages
+ * Page-wise matrix product of two stacks of nPages pages.
+ * C must be an M-by-(N*nPages) Array. */
+template<typename _Scalar>
+void pageMultiply(Array<_Scalar> & a, Array<_Scalar> & b, Array<_Scalar> & c, int nPages) {
+    if (nPages <= 0 || a.getNCols() % nPages != 0 || b.getNCols() % nPages != 0)
+        throw std::runtime_error("Unable to multiply " + a.getName() + " and " + b.getName() + " page-wise. The number of pages must agree.");
+    int m = a.getNRows(), k = a.getNCols() / nPages, n = b.getNCols() / nPages;
+    if (b.getNRows() != k)
+        throw std::runtime_error("Unable to multiply " + a.getName() + " and " + b.getName() + " page-wise. Inner dimensions must agree.");
+    if (c.getNRows() != m || c.getNCols() != n * nPages)
+        throw std::runtime_error("Unable to write the page-wise product to " + c.getName() + ". Array dimensions must agree.");
+    PageKernels<_Scalar>::multiply(a.getData(), b.getData(), c.getData(), m, k, n, nPages);
+}
+
+/** \ingroup pages
+ * Page-wise solution of A X = B for a stack of nPages square pages.
+ * Returns the number of singular pages. */
+template<typename _Scalar>
+int pageSolve(Array<_Scalar> & a, Array<_Scalar> & b, Array<_Scalar> & x, int nPages) {
+    if (nPages <= 0 || a.getNCols() != a.getNRows() * nPages || b.getNCols() % nPages != 0)
+        throw std::runtime_error("Unable to solve " + a.getName() + " page-wise. Pages must be square and the number of pages must agree.");
+    int n = a.getNRows(), r = b.getNCols() / nPages;
+    if (b.getNRows() != n || x.getNRows() != n || x.getNCols() != b.getNCols())
+        throw std::runtime_error("Unable to solve " + a.getName() + " page-wise. Array dimensions must agree.");
+    return PageKernels<_Scalar>::solve(a.getData(), b.getData(), x.getData(), n, r, nPages);
+}
+
+/** \ingroup pages
+ * Page-wise inverse of a stack of nPages square pages.
+ * Returns the number of singular pages. */
+template<typename _Scalar>
+int pageInverse(Array<_Scalar> & a, Array<_Scalar> & x, int nPages) {
+    if (nPages <= 0 || a.getNCols() != a.getNRows() * nPages)
+        throw std::runtime_error("Unable to invert " + a.getName() + " page-wise. Pages must be square.");
+    if (x.getNRows() != a.getNRows() || x.getNCols() != a.getNCols())
+        throw std::runtime_error("Unable to write the page-wise inverse to " + x.getName() + ". Array dimensions must agree.");
+    return PageKernels<_Scalar>::inverse(a.getData(), x.getData(), a.getNRows(), nPages);
+}
+
+/** \ingroup pages
+ * Page-wise lower Cholesky factor of a stack of nPages symmetric positive
+ * definite pages. Returns the number of pages that are not positive definite. */
+template<typename _Scalar>
+int pageCholesky(Array<_Scalar> & a, Array<_Scalar> & l, int nPages) {
+    if (nPages <= 0 || a.getNCols() != a.getNRows() * nPages)
+        throw std::runtime_error("Unable to factorize " + a.getName() + " page-wise. Pages must be square.");
+    if (l.getNRows() != a.getNRows() || l.getNCols() != a.getNCols())
+        throw std::runtime_error("Unable to write the page-wise Cholesky factor to " + l.getName() + ". Array dimensions must agree.");
+    return PageKernels<_Scalar>::cholesky(a.getData(), l.getData(), a.getNRows(), nPages);
+}
+
+#endif
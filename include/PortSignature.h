@@ -0,0 +1,428 @@
+/*
+ * This file is part of EasyLink Library.
+ *
+ * Copyright (c) 2014 FEMTO-ST, ENSMM, UFC, CNRS.
+ *
+ * License: GNU General Public License 3
+ *
+ * Author: Guillaume J. Laurent
+ *
+ */
+
+#ifndef EASYLINK_PORTSIGNATURE_H
+#define EASYLINK_PORTSIGNATURE_H
+
+#include "Array.h"
+
+/** \defgroup signature Port signatures
+ *
+ * Declarative description of the ports of a block or a MEX-function.
+ *
+ * Ports are listed in PortList types, in the order of their index. The index
+ * is usually the value of an enum (name tag):
+ *
+ * \code{.cpp}
+ *     enum inputPortName { U };
+ *     enum outputPortName { Y };
+ *     enum parameterName { GAIN };
+ *
+ *     class Block : public TypedBlock<
+ *             PortList<InputPort<U, double, 3> >,
+ *             PortList<OutputPort<Y, double, 3> >,
+ *             PortList<ParameterPort<GAIN, double, 1, 1, true> > > {
+ *     public:
+ *         void outputs() {
+ *             InputPort<U, double, 3>::View u = in<U>();
+ *             OutputPort<Y, double, 3>::View y = out<Y>();
+ *             double gain = param<GAIN>()[0];
+ *             for (int i = 0; i < 3; i++)
+ *                 y[i] = gain * u[i];
+ *         }
+ *     };
+ * \endcode
+ *
+ * TypedBlock and TypedFunction generate the sizing and checking methods from
+ * the lists. The accessors in, out and param check the index, the type and
+ * the dimensions at compile time and return a PortView without any runtime
+ * check.
+ */
+
+/** \ingroup signature
+ * PortView is a lightweight view of the data of a port. Dimensions given at
+ * compile time (non-negative _Rows or _Cols) are constants, so the loops on
+ * the elements of small ports can be unrolled. Accesses are not range-checked. */
+template<typename _Scalar, int _Rows, int _Cols>
+class PortView {
+public:
+
+    typedef _Scalar Scalar;
+
+    PortView(_Scalar *data, int nRows, int nCols) {
+        this->data = data;
+        this->nrows = nRows;
+        this->ncols = nCols;
+    }
+
+    /** Returns the number of rows. */
+    inline int getNRows() const {
+        return _Rows >= 0 ? _Rows : nrows;
+    }
+
+    /** Returns the number of cols. */
+    inline int getNCols() const {
+        return _Cols >= 0 ? _Cols : ncols;
+    }
+
+    /** Returns the number of elements. */
+    inline int getWidth() const {
+        return getNRows() * getNCols();
+    }
+
+    /** Returns the address of the data. */
+    inline _Scalar* getData() const {
+        return data;
+    }
+
+    /** Access to the element i (no range check). */
+    inline _Scalar & operator[](int i) const {
+        return data[i];
+    }
+
+    /** Access to the element (i,j) (no range check). */
+    inline _Scalar & operator()(int i, int j) const {
+        return data[i + j * getNRows()];
+    }
+
+private:
+
+    _Scalar *data;
+    int nrows, ncols;
+};
+
+/** \ingroup signature
+ * Input port specification: index (name tag), scalar type, dimensions (-1 for
+ * dynamically dimensioned ports) and direct feedthrough. */
+template<int _Index, typename _Scalar, int _Rows, int _Cols = 1, bool _DirectFeedThrough = true>
+struct InputPort {
+    typedef _Scalar Scalar;
+    typedef PortView<const _Scalar, _Rows, _Cols> View;
+
+    enum {
+        index = _Index, rows = _Rows, cols = _Cols, directFeedThrough = _DirectFeedThrough
+    };
+};
+
+/** \ingroup signature
+ * Output port specification: index (name tag), scalar type and dimensions
+ * (-1 for dynamically dimensioned ports). */
+template<int _Index, typename _Scalar, int _Rows, int _Cols = 1 >
+struct OutputPort {
+    typedef _Scalar Scalar;
+    typedef PortView<_Scalar, _Rows, _Cols> View;
+
+    enum {
+        index = _Index, rows = _Rows, cols = _Cols
+    };
+};
+
+/** \ingroup signature
+ * Parameter specification: index (name tag), scalar type, dimensions (-1 for
+ * dynamically dimensioned parameters) and tunability. */
+template<int _Index, typename _Scalar, int _Rows, int _Cols = 1, bool _Tunable = false>
+struct ParameterPort {
+    typedef _Scalar Scalar;
+    typedef PortView<const _Scalar, _Rows, _Cols> View;
+
+    enum {
+        index = _Index, rows = _Rows, cols = _Cols, tunable = _Tunable
+    };
+};
+
+/** \ingroup signature
+ * List of port specifications, sorted by index. */
+template<typename... _Ports>
+struct PortList {
+
+    enum {
+        size = sizeof...(_Ports)
+    };
+};
+
+template<int _Index>
+struct PortIndexError {
+
+    enum {
+        value = 0
+    };
+};
+
+/** \ingroup signature
+ * PortAt<_Index, _List>::type is the specification of port _Index. */
+template<int _Index, typename _List>
+struct PortAt {
+    static_assert(PortIndexError<_Index>::value, "Port index does not exist in the port list.");
+    typedef void type;
+};
+
+template<typename _First, typename... _Rest>
+struct PortAt<0, PortList<_First, _Rest...> > {
+    typedef _First type;
+};
+
+template<int _Index, typename _First, typename... _Rest>
+struct PortAt<_Index, PortList<_First, _Rest...> > {
+    typedef typename PortAt<_Index - 1, PortList<_Rest...> >::type type;
+};
+
+/** \ingroup signature
+ * IsPortListSorted<_List>::value is true if the indices of the ports are
+ * 0, 1, 2... */
+template<typename _List, int _Position = 0 >
+struct IsPortListSorted {
+
+    enum {
+        value = 1
+    };
+};
+
+template<typename _First, typename... _Rest, int _Position>
+struct IsPortListSorted<PortList<_First, _Rest...>, _Position> {
+
+    enum {
+        value = (_First::index == _Position) && IsPortListSorted<PortList<_Rest...>, _Position + 1>::value
+    };
+};
+
+/** \ingroup signature
+ * Calls _Visitor::visit<_Port>(context) for each port of a list. */
+template<typename _List>
+struct ForEachPort {
+
+    template<typename _Visitor, typename _Context>
+    static inline void apply(_Context context) {
+    }
+};
+
+template<typename _First, typename... _Rest>
+struct ForEachPort<PortList<_First, _Rest...> > {
+
+    template<typename _Visitor, typename _Context>
+    static inline void apply(_Context context) {
+        _Visitor::template visit<_First>(context);
+        ForEachPort<PortList<_Rest...> >::template apply<_Visitor>(context);
+    }
+};
+
+#ifdef S_FUNCTION_NAME
+
+/** \ingroup signature
+ * ScalarTypeID gives the Simulink data type identifier matching a C++
+ * scalar type. */
+template<typename _Scalar>
+struct ScalarTypeID {
+    static_assert(sizeof (_Scalar) == 0, "Type not supported by Simulink ports.");
+};
+
+template<> struct ScalarTypeID<double> {
+    static const DTypeId value = SS_DOUBLE;
+};
+
+template<> struct ScalarTypeID<float> {
+    static const DTypeId value = SS_SINGLE;
+};
+
+template<> struct ScalarTypeID<signed char> {
+    static const DTypeId value = SS_INT8;
+};
+
+template<> struct ScalarTypeID<unsigned char> {
+    static const DTypeId value = SS_UINT8;
+};
+
+template<> struct ScalarTypeID<short> {
+    static const DTypeId value = SS_INT16;
+};
+
+template<> struct ScalarTypeID<unsigned short> {
+    static const DTypeId value = SS_UINT16;
+};
+
+template<> struct ScalarTypeID<int> {
+    static const DTypeId value = SS_INT32;
+};
+
+template<> struct ScalarTypeID<unsigned int> {
+    static const DTypeId value = SS_UINT32;
+};
+
+template<> struct ScalarTypeID<bool> {
+    static const DTypeId value = SS_BOOLEAN;
+};
+
+/** \ingroup signature
+ * TypedBlock is the basis class for S-functions whose ports are declared by
+ * port lists.
+ *
+ * checkParametersSizes, initializeInputPortSizes and initializeOutputPortSizes
+ * are generated from the lists and can still be overridden. */
+template<typename _Inputs, typename _Outputs, typename _Parameters = PortList<> >
+class TypedBlock : public BaseBlock {
+    static_assert(IsPortListSorted<_Inputs>::value, "Input ports must be listed in the order of their index, starting from 0.");
+    static_assert(IsPortListSorted<_Outputs>::value, "Output ports must be listed in the order of their index, starting from 0.");
+    static_assert(IsPortListSorted<_Parameters>::value, "Parameters must be listed in the order of their index, starting from 0.");
+
+public:
+
+    /** \ingroup initialization
+     *
+     * Checks the number, the dimensions and the type of the parameters. */
+    static void checkParametersSizes(SimStruct *S) {
+        assertParameterPortsCount(S, _Parameters::size);
+        ForEachPort<_Parameters>::template apply<ParameterChecker>(S);
+    }
+
+    /** \ingroup initialization
+     *
+     * Sets the number, the dimensions and the type of the input ports. */
+    static void initializeInputPortSizes(SimStruct *S) {
+        setInputPortsCount(S, _Inputs::size);
+        ForEachPort<_Inputs>::template apply<InputInitializer>(S);
+    }
+
+    /** \ingroup initialization
+     *
+     * Sets the number, the dimensions and the type of the output ports. */
+    static void initializeOutputPortSizes(SimStruct *S) {
+        setOutputPortsCount(S, _Outputs::size);
+        ForEachPort<_Outputs>::template apply<OutputInitializer>(S);
+    }
+
+    /** \ingroup inputPort
+     *
+     * Returns a view of input port _Index. */
+    template<int _Index>
+    inline typename PortAt<_Index, _Inputs>::type::View in() {
+        typedef typename PortAt<_Index, _Inputs>::type Port;
+        const PortDescriptor &input = inputPorts[_Index];
+        return typename Port::View((const typename Port::Scalar*) input.data, input.nRows, input.nCols);
+    }
+
+    /** \ingroup outputPort
+     *
+     * Returns a view of output port _Index. */
+    template<int _Index>
+    inline typename PortAt<_Index, _Outputs>::type::View out() {
+        typedef typename PortAt<_Index, _Outputs>::type Port;
+        const PortDescriptor &output = outputPorts[_Index];
+        return typename Port::View((typename Port::Scalar*) output.data, output.nRows, output.nCols);
+    }
+
+    /** \ingroup parameterPort
+     *
+     * Returns a view of parameter _Index. */
+    template<int _Index>
+    inline typename PortAt<_Index, _Parameters>::type::View param() {
+        typedef typename PortAt<_Index, _Parameters>::type Port;
+        const ParameterDescriptor &parameter = parameters[_Index];
+        return typename Port::View((const typename Port::Scalar*) parameter.data,
+                Port::rows >= 0 ? Port::rows : parameter.nRows,
+                Port::cols >= 0 ? Port::cols : parameter.nCols);
+    }
+
+private:
+
+    struct ParameterChecker {
+
+        template<typename _Port>
+        static void visit(SimStruct *S) {
+            assertParameterPort(S, _Port::index, _Port::tunable, _Port::rows, _Port::cols, ScalarClassID<typename _Port::Scalar>::value);
+        }
+    };
+
+    struct InputInitializer {
+
+        template<typename _Port>
+        static void visit(SimStruct *S) {
+            setInputPort(S, _Port::index, _Port::rows, _Port::cols, ScalarTypeID<typename _Port::Scalar>::value, _Port::directFeedThrough);
+        }
+    };
+
+    struct OutputInitializer {
+
+        template<typename _Port>
+        static void visit(SimStruct *S) {
+            setOutputPort(S, _Port::index, _Port::rows, _Port::cols, ScalarTypeID<typename _Port::Scalar>::value);
+        }
+    };
+};
+
+#else
+
+/** \ingroup signature
+ * TypedFunction is the basis class for MEX-functions whose arguments are
+ * declared by port lists (InputPort and OutputPort specifications).
+ *
+ * checkInputPortSizes and initializeOutputPortSizes are generated from the
+ * lists. Outputs with dynamic dimensions are not created:
+ * initializeOutputPortSizes must be overridden in this case. */
+template<typename _Inputs, typename _Outputs>
+class TypedFunction : public BaseFunction {
+    static_assert(IsPortListSorted<_Inputs>::value, "Input arguments must be listed in the order of their index, starting from 0.");
+    static_assert(IsPortListSorted<_Outputs>::value, "Output arguments must be listed in the order of their index, starting from 0.");
+
+public:
+
+    /** Checks the number, the dimensions and the type of the input arguments. */
+    static void checkInputPortSizes() {
+        checkInputPortsCount(_Inputs::size);
+        ForEachPort<_Inputs>::template apply<InputChecker>(0);
+    }
+
+    /** Creates the output arguments. */
+    static void initializeOutputPortSizes() {
+        checkOutputPortsCount(_Outputs::size);
+        ForEachPort<_Outputs>::template apply<OutputInitializer>(0);
+    }
+
+    /** Returns a view of input argument _Index. */
+    template<int _Index>
+    static inline typename PortAt<_Index, _Inputs>::type::View in() {
+        typedef typename PortAt<_Index, _Inputs>::type Port;
+        const mxArray *input = prhs[_Index];
+        return typename Port::View((const typename Port::Scalar*) mxGetData(input),
+                Port::rows >= 0 ? Port::rows : (int) mxGetM(input),
+                Port::cols >= 0 ? Port::cols : (int) mxGetN(input));
+    }
+
+    /** Returns a view of output argument _Index. */
+    template<int _Index>
+    static inline typename PortAt<_Index, _Outputs>::type::View out() {
+        typedef typename PortAt<_Index, _Outputs>::type Port;
+        mxArray *output = plhs[_Index];
+        return typename Port::View((typename Port::Scalar*) mxGetData(output),
+                Port::rows >= 0 ? Port::rows : (int) mxGetM(output),
+                Port::cols >= 0 ? Port::cols : (int) mxGetN(output));
+    }
+
+private:
+
+    struct InputChecker {
+
+        template<typename _Port>
+        static void visit(int) {
+            checkInputPort(_Port::index, _Port::rows, _Port::cols, ScalarClassID<typename _Port::Scalar>::value);
+        }
+    };
+
+    struct OutputInitializer {
+
+        template<typename _Port>
+        static void visit(int) {
+            setOutputPort(_Port::index, _Port::rows, _Port::cols, ScalarClassID<typename _Port::Scalar>::value);
+        }
+    };
+};
+
+#endif
+
+#endif
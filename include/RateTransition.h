@@ -0,0 +1,129 @@
+/*
+ * This file is part of EasyLink Library.
+ *
+ * Copyright (c) 2014 FEMTO-ST, ENSMM, UFC, CNRS.
+ *
+ * License: GNU General Public License 3
+ *
+ * Author: Guillaume J. Laurent
+ *
+ */
+
+#ifndef EASYLINK_RATETRANSITION_H
+#define EASYLINK_RATETRANSITION_H
+
+#include "Array.h"
+#include <algorithm>
+#include <atomic>
+#include <vector>
+
+/** RateTransitionBuffer exchanges data between two rates of a multi-rate
+ * block, from one writing rate to one reading rate.
+ *
+ * In multitasking mode, the rates of a block run in different tasks that can
+ * preempt each other. The buffer uses three slots (triple buffering): the
+ * writer fills its own slot and publishes it, the reader takes the latest
+ * published slot. Neither side waits for the other and the reader never sees
+ * a partially written slot.
+ *
+ * \code{.cpp}
+ *     void start() {
+ *         average.resize(1);
+ *     }
+ *
+ *     void updateForRate(int rate) {
+ *         if (rate == FAST_RATE) {
+ *             average.getWriteData()[0] = sum / count;
+ *             average.publish();
+ *         }
+ *     }
+ *
+ *     void outputsForRate(int rate) {
+ *         if (rate == SLOW_RATE)
+ *             setOutputDouble(SLOW, average.getReadData()[0]);
+ *     }
+ * \endcode
+ *
+ * The buffer must be allocated (in start) before the simulation runs. */
+template<typename _Scalar>
+class RateTransitionBuffer {
+public:
+
+    /** Construct a buffer of width elements per slot. */
+    RateTransitionBuffer(int width = 0) {
+        resize(width);
+    }
+
+    /** Allocates the slots and sets all the elements to zero. */
+    void resize(int width) {
+        this->width = width;
+        data.assign(3 * (size_t) width, _Scalar(0));
+        writeSlot = 0;
+        readSlot = 1;
+        latestSlot.store(2);
+    }
+
+    /** Returns the number of elements of a slot. */
+    inline int getWidth() {
+        return width;
+    }
+
+    /** Returns the slot of the writing rate, to fill before calling publish. */
+    inline _Scalar* getWriteData() {
+        return &data[writeSlot * (size_t) width];
+    }
+
+    /** Returns an array mapping the slot of the writing rate. */
+    inline Array<_Scalar> getWriteArray() {
+        return Array<_Scalar>(getWriteData(), width, 1, "rate transition buffer", true);
+    }
+
+    /** Makes the slot of the writing rate available to the reading rate. */
+    inline void publish() {
+        writeSlot = latestSlot.exchange(writeSlot | FRESH) & SLOT_MASK;
+    }
+
+    /** Copies values to the slot of the writing rate and publishes it. */
+    inline void write(const _Scalar *values) {
+        std::copy(values, values + width, getWriteData());
+        publish();
+    }
+
+    /** Returns true if a slot has been published since the last read. */
+    inline bool isFresh() {
+        return (latestSlot.load() & FRESH) != 0;
+    }
+
+    /** Returns the latest published slot. The slot remains valid until the
+     * next call of getReadData. */
+    inline const _Scalar* getReadData() {
+        if (isFresh())
+            readSlot = latestSlot.exchange(readSlot) & SLOT_MASK;
+        return &data[readSlot * (size_t) width];
+    }
+
+    /** Returns an array mapping the latest published slot. */
+    inline Array<_Scalar> getReadArray() {
+        return Array<_Scalar>(getReadData(), width, 1, "rate transition buffer", true);
+    }
+
+    /** Copies the latest published slot to values. */
+    inline void read(_Scalar *values) {
+        const _Scalar *slot = getReadData();
+        std::copy(slot, slot + width, values);
+    }
+
+private:
+
+    enum {
+        SLOT_MASK = 3, FRESH = 4
+    };
+
+    std::vector<_Scalar> data;
+    int width;
+    int writeSlot; // only used by the writing rate
+    int readSlot; // only used by the reading rate
+    std::atomic<int> latestSlot; // latest published slot and fresh flag
+};
+
+#endif
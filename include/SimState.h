@@ -0,0 +1,206 @@
+/*
+ * This file is part of EasyLink Library.
+ *
+ * Copyright (c) 2014 FEMTO-ST, ENSMM, UFC, CNRS.
+ *
+ * License: GNU General Public License 3
+ *
+ * Author: Guillaume J. Laurent
+ *
+ */
+
+#ifndef EASYLINK_SIMSTATE_H
+#define EASYLINK_SIMSTATE_H
+
+#include "Array.h"
+#include "EventQueue.h"
+#include <stdint.h>
+#include <type_traits>
+
+#define SIM_STATE_MAGIC "ELSTATE"
+#define SIM_STATE_VERSION 1
+
+/** Header of the operating point (SimState) of a block.
+ *
+ * The operating point is saved as a uint8 column vector: the header is
+ * followed by the DWorks, the continuous states, the discrete states, the
+ * modes and the data serialized by Block::serializeState. */
+struct SimStateHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t reserved;
+    uint64_t size;
+};
+
+/** SimStateBuffer serializes the state of a block to a binary buffer and
+ * restores it.
+ *
+ * The same serialize calls are used to compute the size of the buffer, to
+ * write it and to read it back, so a block writes a single serializeState
+ * method:
+ *
+ * \code{.cpp}
+ *     void serializeState(SimStateBuffer &state) {
+ *         state.serialize(counter);     // scalar member
+ *         state.serialize(buffer);      // Array member
+ *         state.serialize(matrix);      // Eigen member (or any type with data() and size())
+ *         state.serialize(events);      // EventQueue member
+ *     }
+ * \endcode
+ *
+ * Dimensions are saved with the data and checked when the state is restored,
+ * so members must be allocated before (in start). */
+class SimStateBuffer {
+public:
+
+    enum Mode {
+        SIZING, WRITING, READING
+    };
+
+    /** Construct a buffer that only counts the size of the serialized data. */
+    SimStateBuffer() {
+        mode = SIZING;
+        data = NULL;
+        capacity = 0;
+        position = 0;
+    }
+
+    /** Construct a buffer writing to or reading from size bytes of data. */
+    SimStateBuffer(unsigned char *data, size_t size, Mode mode) {
+        this->mode = mode;
+        this->data = data;
+        this->capacity = size;
+        this->position = 0;
+    }
+
+    /** Returns the mode of the buffer. */
+    inline Mode getMode() {
+        return mode;
+    }
+
+    /** Returns true if the state is being restored. */
+    inline bool isReading() {
+        return mode == READING;
+    }
+
+    /** Returns the number of bytes serialized so far. */
+    inline size_t getSize() {
+        return position;
+    }
+
+    /** Serializes size bytes. */
+    void serialize(void *bytes, size_t size) {
+        if (mode != SIZING && position + size > capacity)
+            throw std::runtime_error("The operating point of the block is truncated.");
+        if (mode == WRITING)
+            memcpy(data + position, bytes, size);
+        else if (mode == READING)
+            memcpy(bytes, data + position, size);
+        position += size;
+    }
+
+    /** Serializes a scalar value. */
+    template<typename T>
+    typename std::enable_if<std::is_arithmetic<T>::value || std::is_enum<T>::value>::type serialize(T & value) {
+        serialize((void*) &value, sizeof (T));
+    }
+
+    /** Serializes an Array. */
+    template<typename _Scalar>
+    void serialize(Array<_Scalar> & array) {
+        int32_t nRows = array.getNRows();
+        int32_t nCols = array.getNCols();
+        serialize(nRows);
+        serialize(nCols);
+        if (nRows != array.getNRows() || nCols != array.getNCols())
+            throw std::runtime_error("Unable to restore " + array.getName() + ". Array dimensions must agree.");
+        serialize((void*) array.getData(), (size_t) array.getWidth() * sizeof (_Scalar));
+    }
+
+    /** Serializes an EventQueue. */
+    template<typename _Event>
+    void serialize(EventQueue<_Event> & queue) {
+        queue.serialize(*this);
+    }
+
+    /** Serializes a contiguous container providing data() and size(), such as
+     * an Eigen matrix or a std::vector. */
+    template<typename T>
+    typename std::enable_if<!std::is_arithmetic<T>::value && !std::is_enum<T>::value>::type serialize(T & container) {
+        uint64_t size = (uint64_t) container.size();
+        serialize(size);
+        if (size != (uint64_t) container.size())
+            throw std::runtime_error("Unable to restore the operating point of the block. Container sizes must agree.");
+        serialize((void*) container.data(), (size_t) container.size() * sizeof (*container.data()));
+    }
+
+private:
+
+    Mode mode;
+    unsigned char *data;
+    size_t capacity;
+    size_t position;
+};
+
+#ifdef S_FUNCTION_NAME
+
+/** Serializes the DWorks, the states and the user data of a block. */
+template<typename _Block>
+void serializeBlockState(SimStruct *S, _Block *block, SimStateBuffer & state) {
+    for (int i = 0; i < ssGetNumDWork(S); i++)
+        state.serialize(ssGetDWork(S, i), (size_t) ssGetDWorkWidth(S, i) * ssGetDataTypeSize(S, ssGetDWorkDataType(S, i)));
+    if (ssGetNumContStates(S) > 0)
+        state.serialize((void*) ssGetContStates(S), ssGetNumContStates(S) * sizeof (real_T));
+    if (ssGetNumDiscStates(S) > 0)
+        state.serialize((void*) ssGetDiscStates(S), ssGetNumDiscStates(S) * sizeof (real_T));
+    if (ssGetNumModes(S) > 0)
+        state.serialize((void*) ssGetModeVector(S), ssGetNumModes(S) * sizeof (int_T));
+    block->serializeState(state);
+}
+
+/** Returns the operating point of a block as a uint8 column vector. */
+template<typename _Block>
+mxArray* getBlockSimState(SimStruct *S, _Block *block) {
+    SimStateBuffer sizing;
+    serializeBlockState(S, block, sizing);
+    size_t size = sizeof (SimStateHeader) + sizing.getSize();
+
+    mxArray *mxarray = mxCreateNumericMatrix(size, 1, mxUINT8_CLASS, mxREAL);
+    if (mxarray == NULL)
+        throw std::runtime_error("Unable to allocate the operating point of the block.");
+    unsigned char *data = (unsigned char*) mxGetData(mxarray);
+
+    SimStateHeader header;
+    memset((void*) &header, 0, sizeof (header));
+    memcpy(header.magic, SIM_STATE_MAGIC, 8);
+    header.version = SIM_STATE_VERSION;
+    header.size = sizing.getSize();
+    memcpy(data, &header, sizeof (header));
+
+    SimStateBuffer writing(data + sizeof (SimStateHeader), sizing.getSize(), SimStateBuffer::WRITING);
+    serializeBlockState(S, block, writing);
+    return mxarray;
+}
+
+/** Restores the operating point of a block saved by getBlockSimState. */
+template<typename _Block>
+void setBlockSimState(SimStruct *S, _Block *block, const mxArray *mxarray) {
+    if (mxGetClassID(mxarray) != mxUINT8_CLASS || mxGetNumberOfElements(mxarray) < sizeof (SimStateHeader))
+        throw std::runtime_error("The operating point of the block is not valid.");
+    const unsigned char *data = (const unsigned char*) mxGetData(mxarray);
+
+    SimStateHeader header;
+    memcpy(&header, data, sizeof (header));
+    if (memcmp(header.magic, SIM_STATE_MAGIC, 8) != 0 || header.version != SIM_STATE_VERSION
+            || header.size != mxGetNumberOfElements(mxarray) - sizeof (SimStateHeader))
+        throw std::runtime_error("The operating point of the block is not valid.");
+
+    SimStateBuffer reading((unsigned char*) data + sizeof (SimStateHeader), (size_t) header.size, SimStateBuffer::READING);
+    serializeBlockState(S, block, reading);
+    if (reading.getSize() != header.size)
+        throw std::runtime_error("The operating point of the block does not match the block.");
+}
+
+#endif
+
+#endif
@@ -16,6 +16,8 @@
 #include <string>
 #include <sstream>
 #include <math.h>
+#include <string.h>
+#include <stdexcept>
 #include <vector>
 
 
@@ -27,7 +29,32 @@
 #endif
 
 //------------------------------------------------------------------------------
-static char ERROR_MSG_BUFFER[512];
+// One buffer per thread, so that blocks running concurrently do not overwrite
+// the error messages of each other.
+static thread_local char ERROR_MSG_BUFFER[512];
+
+//------------------------------------------------------------------------------
+// Exception-free profile (EASYLINK_EXCEPTION_FREE): the classes that do not 
+// know the SimStruct (Array, EigenBridge) record their first error in 
+// ERROR_MSG_BUFFER and return a safe value. The S-function wrappers report the
+// pending error with ssSetErrorStatus when the method of the block returns.
+#ifdef EASYLINK_EXCEPTION_FREE
+static thread_local bool PENDING_ERROR = false;
+
+inline void setPendingError(const std::string & message) {
+    if (PENDING_ERROR)
+        return;
+    strncpy(ERROR_MSG_BUFFER, message.c_str(), sizeof (ERROR_MSG_BUFFER) - 1);
+    ERROR_MSG_BUFFER[sizeof (ERROR_MSG_BUFFER) - 1] = '\0';
+    PENDING_ERROR = true;
+}
+
+#define EASYLINK_ERROR(exception, message) do { setPendingError(message); return; } while (false)
+#define EASYLINK_ERROR_RETURN(exception, message, value) do { setPendingError(message); return value; } while (false)
+#else
+#define EASYLINK_ERROR(exception, message) throw exception(message)
+#define EASYLINK_ERROR_RETURN(exception, message, value) throw exception(message)
+#endif
 
 /** \ingroup utils
  * Converts a double, int or char to a String.
@@ -68,6 +95,16 @@ inline unsigned long getComputerTime() {
 #endif
 }
 
+/** \ingroup utils
+ * Returns true if the compile-time dimensions of a map type (for instance an
+ * Eigen::Map) agree with the given dimensions. A negative compile-time
+ * dimension stands for a dynamic dimension.
+ */
+template <typename _Map> inline bool isMapSizeValid(int nRows, int nCols) {
+    return (_Map::RowsAtCompileTime < 0 || _Map::RowsAtCompileTime == nRows)
+            && (_Map::ColsAtCompileTime < 0 || _Map::ColsAtCompileTime == nCols);
+}
+
 #define EQUALITY_TOLERANCE 0.00000000000001
 
 /** \ingroup utils
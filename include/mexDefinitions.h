@@ -9,6 +9,15 @@
  * 
  */
 
+//------------------------------------------------------------------------------
+#ifdef EASYLINK_NO_MALLOC
+#if defined(EIGEN_WORLD_VERSION) && !defined(EASYLINK_EIGEN_INCLUDED_FIRST)
+bool (*AllocationGuard::allowEigenMalloc)(bool) = &Eigen::internal::set_is_malloc_allowed;
+#else
+bool (*AllocationGuard::allowEigenMalloc)(bool) = NULL;
+#endif
+#endif
+
 //------------------------------------------------------------------------------
 // Definition of the gateway function for MEX functions
 
@@ -20,7 +29,13 @@ void mexFunction(int nlhs, mxArray *plhs[], int nrhs, const mxArray *prhs[]) {
         Function::plhs = &(plhs[0]);
         Function::checkInputPortSizes();
         Function::initializeOutputPortSizes();
+#ifdef EASYLINK_NO_MALLOC
+        AllocationGuard guard(mexFunctionName(), "computeOutputs");
+        Function::computeOutputs();
+        guard.check();
+#else
         Function::computeOutputs();
+#endif
     } catch (std::exception const& e) {
         strcpy(ERROR_MSG_BUFFER, e.what());
         mexErrMsgIdAndTxt("MEXFile:runtimeError", ERROR_MSG_BUFFER);
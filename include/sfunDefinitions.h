@@ -9,6 +9,37 @@
  * 
  */
 
+//------------------------------------------------------------------------------
+// Exception-free profile: the runtime methods (outputs, derivatives, 
+// zeroCrossings, update, timeOfNextHit) are called without try/catch and report
+// their errors with setErrorStatus, so Simulink does not need to protect them.
+// mdlJacobian is not covered by SS_OPTION_RUNTIME_EXCEPTION_FREE_CODE and keeps
+// its try/catch (the Jacobian methods may throw).
+#if defined(EASYLINK_EXCEPTION_FREE) && defined(EASYLINK_NO_MALLOC)
+#error "EASYLINK_EXCEPTION_FREE and EASYLINK_NO_MALLOC cannot be used together."
+#endif
+
+//------------------------------------------------------------------------------
+// Reports the error recorded by Array or EigenBridge in the exception-free 
+// profile (see setPendingError), when a method of the block returns.
+static inline void reportPendingError(SimStruct *S) {
+#ifdef EASYLINK_EXCEPTION_FREE
+    if (PENDING_ERROR) {
+        PENDING_ERROR = false;
+        ssSetErrorStatus(S, ERROR_MSG_BUFFER);
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------
+#ifdef EASYLINK_NO_MALLOC
+#if defined(EIGEN_WORLD_VERSION) && !defined(EASYLINK_EIGEN_INCLUDED_FIRST)
+bool (*AllocationGuard::allowEigenMalloc)(bool) = &Eigen::internal::set_is_malloc_allowed;
+#else
+bool (*AllocationGuard::allowEigenMalloc)(bool) = NULL;
+#endif
+#endif
+
 //------------------------------------------------------------------------------
 #define MDL_CHECK_PARAMETERS
 
@@ -17,8 +48,28 @@ static void mdlCheckParameters(SimStruct *S) {
     printf("EasyLink test message: entering mdlCheckParameters ------------------------------\n");
 #endif
     try {
-        Block::setSimStruct(S);
-        Block::checkParametersSizes();
+        Block::checkParametersSizes(S);
+    } catch (std::exception const& e) {
+        strcpy(ERROR_MSG_BUFFER, e.what());
+        ssSetErrorStatus(S, ERROR_MSG_BUFFER);
+        return;
+    }
+}
+
+//------------------------------------------------------------------------------
+#define MDL_PROCESS_PARAMETERS
+
+static void mdlProcessParameters(SimStruct *S) {
+#ifdef __TEST__
+    printf("EasyLink test message: entering mdlProcessParameters ----------------------------\n");
+#endif
+    Block *block = (Block *) ssGetPWork(S)[0];
+    try {
+#ifdef MATLAB_MEX_FILE
+        Block::updateRunTimeParameters(S);
+#endif
+        if (block != NULL && block->refreshParameters())
+            block->processParameters();
     } catch (std::exception const& e) {
         strcpy(ERROR_MSG_BUFFER, e.what());
         ssSetErrorStatus(S, ERROR_MSG_BUFFER);
@@ -34,17 +85,41 @@ static void mdlInitializeSizes(SimStruct *S) {
     printf("EasyLink test message: entering mdlInitializeSizes ------------------------------\n");
 #endif
     try {
-        Block::setSimStruct(S);
         //Block::initializeParameterPortSizes();
-        Block::checkParametersSizes();
-        Block::initializeInputPortSizes();
-        Block::initializeOutputPortSizes();
-        Block::initializeStatePortSizes();
+        Block::checkParametersSizes(S);
+        Block::initializeInputPortSizes(S);
+        Block::initializeOutputPortSizes(S);
+        Block::initializeStatePortSizes(S);
         ssSetNumRWork(S, 0);
         ssSetNumIWork(S, 0);
         ssSetNumPWork(S, 1);
-        Block::initializeNumberSampleTimes();
-        Block::initializeOptions();
+        Block::initializeNumberSampleTimes(S);
+        if (BlockMethods<Block>::serializeState)
+            ssSetSimStateCompliance(S, USE_CUSTOM_SIM_STATE);
+        int_T options = ssGetOptions(S);
+        Block::initializeOptions(S);
+        // Keep the constant sample time option of setPortBasedSampleTimes
+        ssSetOptions(S, ssGetOptions(S) | (options & SS_OPTION_ALLOW_CONSTANT_PORT_SAMPLE_TIME));
+#ifdef EASYLINK_EXCEPTION_FREE
+        ssSetOptions(S, ssGetOptions(S) | SS_OPTION_RUNTIME_EXCEPTION_FREE_CODE);
+#endif
+#ifdef MATLAB_MEX_FILE
+        // Simulink does not call the methods that the block does not implement.
+        // The ssSetmdl* macros are internals of the MEX SimStruct: the generated
+        // code of a model registers and calls every wrapper.
+#ifdef ssSetmdlDerivatives
+        if (!BlockMethods<Block>::derivatives) ssSetmdlDerivatives(S, NULL);
+#endif
+#ifdef ssSetmdlZeroCrossings
+        if (!BlockMethods<Block>::zeroCrossings) ssSetmdlZeroCrossings(S, NULL);
+#endif
+#ifdef ssSetmdlJacobian
+        if (!BlockMethods<Block>::jacobian) ssSetmdlJacobian(S, NULL);
+#endif
+#ifdef ssSetmdlUpdate
+        if (!BlockMethods<Block>::update && !BlockMethods<Block>::updateForRate) ssSetmdlUpdate(S, NULL);
+#endif
+#endif
     } catch (std::exception const& e) {
         strcpy(ERROR_MSG_BUFFER, e.what());
         ssSetErrorStatus(S, ERROR_MSG_BUFFER);
@@ -60,15 +135,16 @@ static void mdlSetInputPortDimensionInfo(SimStruct *S, int port, const DimsInfo_
     printf("EasyLink test message: entering mdlSetInputPortDimensionInfo --------------------\n");
 #endif
     try {
-        Block::setSimStruct(S);
         if (dimsInfo->numDims == 1) {
-            Block::checkInputPortFinalSizes(port, dimsInfo->width, 1);
+            Block::checkInputPortFinalSizes(S, port, dimsInfo->width, 1);
         } else if (dimsInfo->numDims == 2) {
-            Block::checkInputPortFinalSizes(port, dimsInfo->dims[0], dimsInfo->dims[1]);
+            Block::checkInputPortFinalSizes(S, port, dimsInfo->dims[0], dimsInfo->dims[1]);
         } else {
             throw std::runtime_error("Input port dimensions greater than two are not supported by easylink.");
         }
         if (!ssSetInputPortDimensionInfo(S, port, dimsInfo)) return;
+        if (ssGetInputPortFrameData(S, port) != FRAME_NO && dimsInfo->numDims == 2)
+            Block::setFrameOutputPortSizes(S, dimsInfo->dims[0], dimsInfo->dims[1]);
     } catch (std::exception const& e) {
         strcpy(ERROR_MSG_BUFFER, e.what());
         ssSetErrorStatus(S, ERROR_MSG_BUFFER);
@@ -84,11 +160,10 @@ static void mdlSetOutputPortDimensionInfo(SimStruct *S, int port, const DimsInfo
     printf("EasyLink test message: entering mdlSetOutputPortDimensionInfo -------------------\n");
 #endif
     try {
-        Block::setSimStruct(S);
         if (dimsInfo->numDims == 1) {
-            Block::checkOutputPortFinalSizes(port, dimsInfo->width, 1);
+            Block::checkOutputPortFinalSizes(S, port, dimsInfo->width, 1);
         } else if (dimsInfo->numDims == 2) {
-            Block::checkOutputPortFinalSizes(port, dimsInfo->dims[0], dimsInfo->dims[1]);
+            Block::checkOutputPortFinalSizes(S, port, dimsInfo->dims[0], dimsInfo->dims[1]);
         } else {
             throw std::runtime_error("Output port dimensions greater than two are not supported by easylink.");
         }
@@ -100,6 +175,82 @@ static void mdlSetOutputPortDimensionInfo(SimStruct *S, int port, const DimsInfo
     }
 }
 
+//---------------------------------------------------------------------------
+#define MDL_SET_INPUT_PORT_FRAME_DATA
+#if defined(MDL_SET_INPUT_PORT_FRAME_DATA) && defined(MATLAB_MEX_FILE)
+
+static void mdlSetInputPortFrameData(SimStruct *S, int port, Frame_T frameData) {
+#ifdef __TEST__
+    printf("EasyLink test message: entering mdlSetInputPortFrameData ------------------------\n");
+#endif
+    try {
+        Block::checkInputPortFrameData(S, port, frameData);
+        ssSetInputPortFrameData(S, port, frameData);
+        Block::setInheritedOutputFrameData(S);
+    } catch (std::exception const& e) {
+        strcpy(ERROR_MSG_BUFFER, e.what());
+        ssSetErrorStatus(S, ERROR_MSG_BUFFER);
+        return;
+    }
+}
+#endif
+
+//------------------------------------------------------------------------------
+#define MDL_SET_INPUT_PORT_SAMPLE_TIME
+#if defined(MDL_SET_INPUT_PORT_SAMPLE_TIME) && defined(MATLAB_MEX_FILE)
+
+static void mdlSetInputPortSampleTime(SimStruct *S, int port, real_T sampleTime, real_T offsetTime) {
+#ifdef __TEST__
+    printf("EasyLink test message: entering mdlSetInputPortSampleTime -----------------------\n");
+#endif
+    try {
+        Block::setInputPortSampleTime(S, port, sampleTime, offsetTime);
+    } catch (std::exception const& e) {
+        strcpy(ERROR_MSG_BUFFER, e.what());
+        ssSetErrorStatus(S, ERROR_MSG_BUFFER);
+        return;
+    }
+}
+#endif
+
+//------------------------------------------------------------------------------
+#define MDL_SET_OUTPUT_PORT_SAMPLE_TIME
+#if defined(MDL_SET_OUTPUT_PORT_SAMPLE_TIME) && defined(MATLAB_MEX_FILE)
+
+static void mdlSetOutputPortSampleTime(SimStruct *S, int port, real_T sampleTime, real_T offsetTime) {
+#ifdef __TEST__
+    printf("EasyLink test message: entering mdlSetOutputPortSampleTime ----------------------\n");
+#endif
+    try {
+        Block::setOutputPortSampleTime(S, port, sampleTime, offsetTime);
+    } catch (std::exception const& e) {
+        strcpy(ERROR_MSG_BUFFER, e.what());
+        ssSetErrorStatus(S, ERROR_MSG_BUFFER);
+        return;
+    }
+}
+#endif
+
+//------------------------------------------------------------------------------
+#define MDL_SET_WORK_WIDTHS
+#if defined(MDL_SET_WORK_WIDTHS) && defined(MATLAB_MEX_FILE)
+
+static void mdlSetWorkWidths(SimStruct *S) {
+#ifdef __TEST__
+    printf("EasyLink test message: entering mdlSetWorkWidths --------------------------------\n");
+#endif
+    try {
+        Block::registerRunTimeParameters(S);
+        Block::initializeVariableSizeOutputs(S);
+        Block::initializeWorkVectors(S);
+    } catch (std::exception const& e) {
+        strcpy(ERROR_MSG_BUFFER, e.what());
+        ssSetErrorStatus(S, ERROR_MSG_BUFFER);
+        return;
+    }
+}
+#endif
+
 //------------------------------------------------------------------------------
 #define MDL_INITIALIZE_SAMPLE_TIME
 
@@ -108,8 +259,13 @@ static void mdlInitializeSampleTimes(SimStruct *S) {
     printf("EasyLink test message: entering mdlInitializeSampleTimes ------------------------\n");
 #endif
     try {
-        Block::setSimStruct(S);
-        Block::initializeSampleTimes();
+        // Port-based sample times are set port by port
+        if (ssGetNumSampleTimes(S) != PORT_BASED_SAMPLE_TIMES)
+            Block::initializeSampleTimes(S);
+        // Simulink needs the time of the next hit of a variable sample time
+        for (int i = 0; i < ssGetNumSampleTimes(S); i++)
+            if (ssGetSampleTime(S, i) == VARIABLE_SAMPLE_TIME && !BlockMethods<Block>::timeOfNextHit)
+                throw std::runtime_error("A block with a variable sample time must implement timeOfNextHit.");
     } catch (std::exception const& e) {
         strcpy(ERROR_MSG_BUFFER, e.what());
         ssSetErrorStatus(S, ERROR_MSG_BUFFER);
@@ -127,8 +283,10 @@ static void mdlStart(SimStruct *S) {
     Block *block = new Block;
     ssGetPWork(S)[0] = (void *) block;
     try {
-        Block::setSimStruct(S);
+        block->setSimStruct(S);
         block->start();
+        block->processParameters();
+        reportPendingError(S);
     } catch (std::exception const& e) {
         strcpy(ERROR_MSG_BUFFER, e.what());
         ssSetErrorStatus(S, ERROR_MSG_BUFFER);
@@ -136,71 +294,220 @@ static void mdlStart(SimStruct *S) {
     }
 }
 
+//------------------------------------------------------------------------------
+// Multi-rate blocks are called once for each rate that has a hit in the task
+
+static inline void blockOutputs(SimStruct *S, Block *block, int tid) {
+    if (BlockMethods<Block>::updateModes && ssIsMajorTimeStep(S))
+        block->updateModes();
+    if (BlockMethods<Block>::outputsForRate) {
+        for (int rate = 0; rate < ssGetNumSampleTimes(S); rate++)
+            if (ssIsSampleHit(S, rate, tid))
+                block->outputsForRate(rate);
+    } else if (BlockMethods<Block>::outputsFrame && block->hasFrameInputs()) {
+        block->outputsFrame();
+    } else {
+        block->outputs();
+    }
+}
+
+static inline void blockUpdate(SimStruct *S, Block *block, int tid) {
+    if (BlockMethods<Block>::updateForRate) {
+        for (int rate = 0; rate < ssGetNumSampleTimes(S); rate++)
+            if (ssIsSampleHit(S, rate, tid))
+                block->updateForRate(rate);
+    } else {
+        block->update();
+    }
+}
+
 //------------------------------------------------------------------------------
 #define MDL_OUTPUTS
 
 static void mdlOutputs(SimStruct *S, int tid) {
 #ifdef __TEST__
-    printf("EasyLink test message: entering mdlOutputs at time %f ---------------------------\n", Block::getSimulationTime());
+    printf("EasyLink test message: entering mdlOutputs at time %f ---------------------------\n", ssGetT(S));
 #endif
     Block *block = (Block *) ssGetPWork(S)[0];
+#ifdef EASYLINK_EXCEPTION_FREE
+    blockOutputs(S, block, tid);
+    reportPendingError(S);
+#else
     try {
-        Block::setSimStruct(S);
-        block->outputs();
+#ifdef EASYLINK_NO_MALLOC
+        AllocationGuard guard(ssGetPath(S), "outputs");
+        blockOutputs(S, block, tid);
+        guard.check();
+#else
+        blockOutputs(S, block, tid);
+#endif
     } catch (std::exception const& e) {
         strcpy(ERROR_MSG_BUFFER, e.what());
         ssSetErrorStatus(S, ERROR_MSG_BUFFER);
         return;
     }
+#endif
+}
+
+//------------------------------------------------------------------------------
+#define MDL_GET_TIME_OF_NEXT_VAR_HIT
+
+static void mdlGetTimeOfNextVarHit(SimStruct *S) {
+    if (!BlockMethods<Block>::timeOfNextHit)
+        return;
+#ifdef __TEST__
+    printf("EasyLink test message: entering mdlGetTimeOfNextVarHit --------------------------\n");
+#endif
+    Block *block = (Block *) ssGetPWork(S)[0];
+#ifdef EASYLINK_EXCEPTION_FREE
+    ssSetTNext(S, block->timeOfNextHit());
+    reportPendingError(S);
+#else
+    try {
+        ssSetTNext(S, block->timeOfNextHit());
+    } catch (std::exception const& e) {
+        strcpy(ERROR_MSG_BUFFER, e.what());
+        ssSetErrorStatus(S, ERROR_MSG_BUFFER);
+        return;
+    }
+#endif
 }
 
 //------------------------------------------------------------------------------
 #define MDL_DERIVATIVES
 
 static void mdlDerivatives(SimStruct *S) {
+    if (!BlockMethods<Block>::derivatives)
+        return;
 #ifdef __TEST__
     printf("EasyLink test message: entering mdlDerivatives ----------------------------------\n");
 #endif
     Block *block = (Block *) ssGetPWork(S)[0];
+#ifdef EASYLINK_EXCEPTION_FREE
+    block->derivatives();
+    reportPendingError(S);
+#else
     try {
-        Block::setSimStruct(S);
+#ifdef EASYLINK_NO_MALLOC
+        AllocationGuard guard(ssGetPath(S), "derivatives");
         block->derivatives();
+        guard.check();
+#else
+        block->derivatives();
+#endif
     } catch (std::exception const& e) {
         strcpy(ERROR_MSG_BUFFER, e.what());
         ssSetErrorStatus(S, ERROR_MSG_BUFFER);
         return;
     }
+#endif
 }
 
 //------------------------------------------------------------------------------
 #define MDL_ZERO_CROSSINGS
 
 static void mdlZeroCrossings(SimStruct *S) {
+    if (!BlockMethods<Block>::zeroCrossings)
+        return;
 #ifdef __TEST__
     printf("EasyLink test message: entering mdlZeroCrossings --------------------------------\n");
 #endif
     Block *block = (Block *) ssGetPWork(S)[0];
+#ifdef EASYLINK_EXCEPTION_FREE
+    block->zeroCrossings();
+    reportPendingError(S);
+#else
     try {
-        Block::setSimStruct(S);
+#ifdef EASYLINK_NO_MALLOC
+        AllocationGuard guard(ssGetPath(S), "zeroCrossings");
         block->zeroCrossings();
+        guard.check();
+#else
+        block->zeroCrossings();
+#endif
     } catch (std::exception const& e) {
         strcpy(ERROR_MSG_BUFFER, e.what());
         ssSetErrorStatus(S, ERROR_MSG_BUFFER);
         return;
     }
+#endif
 }
 
 //------------------------------------------------------------------------------
 #define MDL_UPDATE
 
 static void mdlUpdate(SimStruct *S, int tid) {
+    if (!BlockMethods<Block>::update && !BlockMethods<Block>::updateForRate)
+        return;
 #ifdef __TEST__
     printf("EasyLink test message: entering mdlUpdate ---------------------------------------\n");
 #endif
     Block *block = (Block *) ssGetPWork(S)[0];
+#ifdef EASYLINK_EXCEPTION_FREE
+    blockUpdate(S, block, tid);
+    reportPendingError(S);
+#else
     try {
-        Block::setSimStruct(S);
-        block->update();
+#ifdef EASYLINK_NO_MALLOC
+        AllocationGuard guard(ssGetPath(S), "update");
+        blockUpdate(S, block, tid);
+        guard.check();
+#else
+        blockUpdate(S, block, tid);
+#endif
+    } catch (std::exception const& e) {
+        strcpy(ERROR_MSG_BUFFER, e.what());
+        ssSetErrorStatus(S, ERROR_MSG_BUFFER);
+        return;
+    }
+#endif
+}
+
+//------------------------------------------------------------------------------
+#define MDL_JACOBIAN
+
+static void mdlJacobian(SimStruct *S) {
+    if (!BlockMethods<Block>::jacobian)
+        return;
+#ifdef __TEST__
+    printf("EasyLink test message: entering mdlJacobian -------------------------------------\n");
+#endif
+    Block *block = (Block *) ssGetPWork(S)[0];
+    try {
+        block->writeJacobianPattern();
+        block->jacobian();
+        reportPendingError(S);
+    } catch (std::exception const& e) {
+        strcpy(ERROR_MSG_BUFFER, e.what());
+        ssSetErrorStatus(S, ERROR_MSG_BUFFER);
+        return;
+    }
+}
+
+//------------------------------------------------------------------------------
+#define MDL_SIM_STATE
+
+static mxArray* mdlGetSimState(SimStruct *S) {
+#ifdef __TEST__
+    printf("EasyLink test message: entering mdlGetSimState ----------------------------------\n");
+#endif
+    Block *block = (Block *) ssGetPWork(S)[0];
+    try {
+        return getBlockSimState(S, block);
+    } catch (std::exception const& e) {
+        strcpy(ERROR_MSG_BUFFER, e.what());
+        ssSetErrorStatus(S, ERROR_MSG_BUFFER);
+        return NULL;
+    }
+}
+
+static void mdlSetSimState(SimStruct *S, const mxArray *simState) {
+#ifdef __TEST__
+    printf("EasyLink test message: entering mdlSetSimState ----------------------------------\n");
+#endif
+    Block *block = (Block *) ssGetPWork(S)[0];
+    try {
+        setBlockSimState(S, block, simState);
     } catch (std::exception const& e) {
         strcpy(ERROR_MSG_BUFFER, e.what());
         ssSetErrorStatus(S, ERROR_MSG_BUFFER);
@@ -217,14 +524,17 @@ static void mdlTerminate(SimStruct *S) {
 #endif
     Block *block = (Block *) ssGetPWork(S)[0];
     try {
-        Block::setSimStruct(S);
         block->terminate();
+        reportPendingError(S);
         delete block;
     } catch (std::exception const& e) {
         strcpy(ERROR_MSG_BUFFER, e.what());
         ssSetErrorStatus(S, ERROR_MSG_BUFFER);
         return;
     }
+#ifdef EASYLINK_NO_MALLOC
+    AllocationGuard::report(ssGetPath(S));
+#endif
 #ifdef __TEST__
     printf("EasyLink test message: allocation number = %i.\n", Array<double>::allocationNumber);
 #endif
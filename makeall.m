@@ -6,15 +6,28 @@ function makeall
 
 make mexArrayProduct.cpp
 make mexArrayProductWithEigen.cpp
+make mexFindPeaks.cpp
+make mexPageSolve.cpp
+make mexWriteMappedArray.cpp
+make sfunBus.cpp
+make sfunFrameGain.cpp
 make sfunInputs.cpp
 make sfunMatlabArrays.cpp
+make sfunMultiRate.cpp
 make sfunOffset.cpp
 make sfunOutputs.cpp
 make sfunParameters.cpp
+make sfunPolynomial.cpp
+make sfunSaturation.cpp
+make sfunScheduledEvents.cpp
 make sfunSizeChange.cpp
 make sfunStateSpace.cpp
+make sfunSum.cpp
+make sfunTypedGain.cpp
 make sfunTimesTwo.cpp
 make sfunTimesTwoWithEigen.cpp
+make sfunVanDerPol.cpp
+make sfunVariableSize.cpp
 
 
 
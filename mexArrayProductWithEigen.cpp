@@ -17,13 +17,7 @@
 //------------------------------------------------------------------------------
 
 #include "EasyLink.h"
-
-#include <Eigen/Dense>
-
-#define EIGEN_INPUT_MATRIX(type, name, port) Eigen::Map<Eigen::Matrix<type, Eigen::Dynamic, Eigen::Dynamic> > name((type*)getInputData(port), getInputNRows(port), getInputNCols(port))
-#define EIGEN_INPUT_ARRAY(type, name, port) Eigen::Map<Eigen::Array<type, Eigen::Dynamic, Eigen::Dynamic> > name((type*)getInputData(port), getInputNRows(port), getInputNCols(port))
-#define EIGEN_OUTPUT_MATRIX(type, name, port) Eigen::Map<Eigen::Matrix<type, Eigen::Dynamic, Eigen::Dynamic> > name((type*)getOutputData(port), getOutputNRows(port), getOutputNCols(port))
-#define EIGEN_OUTPUT_ARRAY(type, name, port) Eigen::Map<Eigen::Array<type, Eigen::Dynamic, Eigen::Dynamic> > name((type*)getOutputData(port), getOutputNRows(port), getOutputNCols(port))
+#include "EigenBridge.h"
 
 //------------------------------------------------------------------------------
 
@@ -48,8 +42,8 @@ public:
     // Calculates the function using Eigen
     static void computeOutputs() {
         double multiplier = getInputDouble(0);
-        EIGEN_INPUT_ARRAY(double, inArray, 1);
-        EIGEN_OUTPUT_ARRAY(double, outArray, 0);
+        ConstArrayMap<double> inArray = getInputMap<ConstArrayMap<double> >(1);
+        ArrayMap<double> outArray = getOutputMap<ArrayMap<double> >(0);
         outArray = inArray*multiplier;
     }
 
@@ -0,0 +1,64 @@
+/* 
+ * This file illustrates how to return outputs whose size is not known in
+ * advance with a C++ MEX-File and EasyLink.
+ *
+ * The function finds the local maxima of an input vector that are greater 
+ * than a threshold and outputs their indices and values as a 2xK array.
+ *
+ * The calling syntax is:
+ *
+ *     peaks = mexFindPeaks(threshold, inVector)
+ *
+ * To compile this C++ MEX-File, enter the following command in MATLAB:
+ *
+ *     >>make mexFindPeaks.cpp
+ *
+ */
+
+//------------------------------------------------------------------------------
+
+#include "EasyLink.h"
+
+//------------------------------------------------------------------------------
+
+class Function : public BaseFunction {
+public:
+
+    // Checks the number and the sizes of the input ports of the function 
+    // (right-side arguments)
+    static void checkInputPortSizes() {
+        checkInputPortsCount(2);
+        checkInputPort(0, 1, 1, mxDOUBLE_CLASS);
+        checkInputPort(1, -1, 1, mxDOUBLE_CLASS);
+    }
+
+    // Specifies the number of the output ports of the function (left-side 
+    // arguments). The size of the output is unknown until the peaks are found.
+    static void initializeOutputPortSizes() {
+        checkOutputPortsCount(1);
+    }
+
+    // Finds the peaks and hands the result over to the output port
+    static void computeOutputs() {
+        double threshold = getInputDouble(0);
+        const double *in = (const double*) getInputData(1);
+        int n = getInputWidth(1);
+
+        ArrayBuilder<double> peaks(2);
+        for (int i = 1; i < n - 1; i++) {
+            if (in[i] > threshold && in[i] > in[i - 1] && in[i] >= in[i + 1]) {
+                double *peak = peaks.appendColumn();
+                peak[0] = i + 1;
+                peak[1] = in[i];
+            }
+        }
+        setOutputPort(0, peaks);
+    }
+
+};
+
+//------------------------------------------------------------------------------
+
+#include "mexDefinitions.h"
+
+//------------------------------------------------------------------------------
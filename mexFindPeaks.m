@@ -0,0 +1,7 @@
+% mexFindPeaks Finds the local maxima of a vector above a threshold
+%
+% P = mexFindPeaks(threshold, x) returns a 2xK array whose columns are the
+% indices and the values of the local maxima of the column vector x that are
+% greater than threshold.
+%
+% Created with EasyLink
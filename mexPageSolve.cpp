@@ -0,0 +1,60 @@
+/* 
+ * This file illustrates how to construct a C++ MEX-File processing stacks of
+ * small matrices with EasyLink.
+ *
+ * The function solves the linear systems A(:,:,p) * X(:,:,p) = B(:,:,p) for 
+ * each page p of an NxNxP array A and an NxRxP array B, and outputs the 
+ * NxRxP array X. Pages are solved in batches (see PageKernels.h).
+ *
+ * The calling syntax is:
+ *
+ *     X = mexPageSolve(A, B)
+ *
+ * To compile this C++ MEX-File, enter the following command in MATLAB:
+ *
+ *     >>make mexPageSolve.cpp
+ *
+ */
+
+//------------------------------------------------------------------------------
+
+#include "EasyLink.h"
+
+//------------------------------------------------------------------------------
+
+class Function : public BaseFunction {
+public:
+
+    // Checks the number and the sizes of the input ports of the function 
+    // (right-side arguments)
+    static void checkInputPortSizes() {
+        checkInputPortsCount(2);
+        checkInputPages(0, -1, -1, -1, mxDOUBLE_CLASS);
+        checkInputPages(1, getInputNRows(0), -1, getInputNPages(0), mxDOUBLE_CLASS);
+        if (getInputPageNCols(0) != getInputNRows(0))
+            throw std::runtime_error("Pages of input argument 0 must be square.");
+    }
+
+    // Specifies the number and the sizes of the output ports of the function
+    // (left-side arguments)
+    static void initializeOutputPortSizes() {
+        checkOutputPortsCount(1);
+        setOutputPages(0, getInputNRows(1), getInputPageNCols(1), getInputNPages(1), mxDOUBLE_CLASS);
+    }
+
+    // Calculates the function
+    static void computeOutputs() {
+        Array<double> a = getInputArray<double>(0);
+        Array<double> b = getInputArray<double>(1);
+        Array<double> x = getOutputArray<double>(0);
+        if (pageSolve(a, b, x, getInputNPages(0)) > 0)
+            mexWarnMsgIdAndTxt("EasyLink:singularPage", "Some pages are singular to working precision.");
+    }
+
+};
+
+//------------------------------------------------------------------------------
+
+#include "mexDefinitions.h"
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,7 @@
+% mexPageSolve Solves the linear systems of a stack of small matrices
+%
+% X = mexPageSolve(A, B) returns the NxRxP array X such that
+% A(:,:,p) * X(:,:,p) = B(:,:,p) for each page p, where A is NxNxP and B is
+% NxRxP.
+%
+% Created with EasyLink
@@ -0,0 +1,59 @@
+/* 
+ * This file illustrates how to produce files for MappedArray with a C++
+ * MEX-File and EasyLink.
+ *
+ * The function writes a numeric NxM array to a binary file that can be mapped
+ * in memory by S-functions or MEX-functions using the MappedArray class.
+ *
+ * The calling syntax is:
+ *
+ *     mexWriteMappedArray(filename, inArray)
+ *
+ * To compile this C++ MEX-File, enter the following command in MATLAB:
+ *
+ *     >>make mexWriteMappedArray.cpp
+ *
+ */
+
+//------------------------------------------------------------------------------
+
+#include "EasyLink.h"
+
+//------------------------------------------------------------------------------
+
+class Function : public BaseFunction {
+public:
+
+    // Checks the number and the sizes of the input ports of the function 
+    // (right-side arguments)
+    static void checkInputPortSizes() {
+        checkInputPortsCount(2);
+        checkInputPort(0, 1, -1, mxCHAR_CLASS);
+        if (!mxIsNumeric(prhs[1]) && !mxIsLogical(prhs[1])) {
+            throw std::runtime_error("Input argument 1 must be a numeric array.");
+        }
+        if (mxIsSparse(prhs[1]) || mxIsComplex(prhs[1])) {
+            throw std::runtime_error("Input argument 1 must be a dense real array.");
+        }
+    }
+
+    // Specifies the number and the sizes of the output ports of the function
+    // (left-side arguments)
+    static void initializeOutputPortSizes() {
+        checkOutputPortsCount(0);
+    }
+
+    // Writes the array and its header in the file
+    static void computeOutputs() {
+        std::string filename = getInputString(0);
+        writeMappedArray(filename, getInputData(1), getInputNRows(1), getInputNCols(1),
+                mxGetClassID(prhs[1]), mxGetElementSize(prhs[1]));
+    }
+
+};
+
+//------------------------------------------------------------------------------
+
+#include "mexDefinitions.h"
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,7 @@
+% mexWriteMappedArray Writes an array to a file readable by MappedArray
+%
+% mexWriteMappedArray(filename, A) writes the numeric matrix A to the binary
+% file filename. The file can then be mapped in memory by EasyLink blocks
+% and functions using the MappedArray class.
+%
+% Created with EasyLink
@@ -0,0 +1,19 @@
+function makeInfo = rtwmakecfg()
+% RTWMAKECFG Add EasyLink to the build of generated code.
+%
+% Simulink calls RTWMAKECFG when it builds the code of a model (Rapid
+% Accelerator, Simulink Coder) containing S-functions of this folder. The
+% S-functions written with EasyLink are then compiled from their C++ source
+% as non-inlined S-functions.
+%
+% Copy this file in the folder of your S-functions if they are not in the
+% EasyLink folder.
+%
+% RTWMAKECFG is part of EasyLink Library.
+% Copyright(c) 2014 FEMTO-ST, ENSMM, UFC, CNRS.
+
+path = fileparts(which('make.m'));
+
+makeInfo.includePath = {fullfile(path, 'include'), fullfile(path, '3rdparty')};
+makeInfo.sourcePath = {fileparts(mfilename('fullpath'))};
+makeInfo.library = {};
@@ -0,0 +1,81 @@
+/* 
+ * This file illustrates how to use bus signals with EasyLink.  The
+ * S-function saturates the value of an input bus between the limits carried
+ * by the same bus, and outputs a bus with the saturated value and a flag,
+ *
+ *   y.value = min(max(u.value, u.lower), u.upper)
+ *   y.saturated = (y.value != u.value)
+ *
+ * The buses are defined by two Simulink.Bus objects of the MATLAB workspace:
+ *
+ *   >>elems(1) = Simulink.BusElement; elems(1).Name = 'value';
+ *   >>elems(2) = Simulink.BusElement; elems(2).Name = 'lower';
+ *   >>elems(3) = Simulink.BusElement; elems(3).Name = 'upper';
+ *   >>LimitsBus = Simulink.Bus; LimitsBus.Elements = elems;
+ *   >>elems = Simulink.BusElement.empty;
+ *   >>elems(1) = Simulink.BusElement; elems(1).Name = 'value';
+ *   >>elems(2) = Simulink.BusElement; elems(2).Name = 'saturated'; elems(2).DataType = 'int32';
+ *   >>StatusBus = Simulink.Bus; StatusBus.Elements = elems;
+ *
+ * To compile this C++ S-function, enter the following command in MATLAB:
+ *
+ *   >>make sfunBus.cpp
+ */
+
+//------------------------------------------------------------------------------
+
+#define S_FUNCTION_NAME  sfunBus
+
+#include "EasyLink.h"
+#include <cstddef>
+
+//------------------------------------------------------------------------------
+
+// C++ structs with the layout of the buses
+struct LimitsBus {
+    double value;
+    double lower;
+    double upper;
+};
+
+struct StatusBus {
+    double value;
+    int32_T saturated;
+};
+
+//------------------------------------------------------------------------------
+
+class Block : public BaseBlock {
+public:
+
+    static void initializeInputPortSizes(SimStruct *S) {
+        setInputPortsCount(S, 1);
+        setInputBusPort(S, 0, "LimitsBus");
+    }
+
+    static void initializeOutputPortSizes(SimStruct *S) {
+        setOutputPortsCount(S, 1);
+        setOutputBusPort(S, 0, "StatusBus");
+    }
+
+    // The layouts are checked once, the buses are then used without copy
+    void start() {
+        assertInputBusLayout<LimitsBus>(0, {offsetof(LimitsBus, value), offsetof(LimitsBus, lower), offsetof(LimitsBus, upper)});
+        assertOutputBusLayout<StatusBus>(0, {offsetof(StatusBus, value), offsetof(StatusBus, saturated)});
+    }
+
+    void outputs() {
+        const LimitsBus &in = getInputBus<LimitsBus>(0);
+        StatusBus &out = getOutputBus<StatusBus>(0);
+
+        out.value = in.value < in.lower ? in.lower : (in.value > in.upper ? in.upper : in.value);
+        out.saturated = out.value != in.value;
+    }
+
+};
+
+//------------------------------------------------------------------------------
+
+#include "sfunDefinitions.h"
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,88 @@
+/* 
+ * This file illustrates how to process frames with EasyLink.  The S-function
+ * multiplies its input by a scalar gain,
+ *
+ *   y = k * u
+ *
+ * The input accepts samples or frames (frame size by number of channels).
+ * The output inherits the frame data and the dimensions of the input. Frames
+ * are processed by outputsFrame, one channel (one contiguous column) at a time.
+ *
+ * To compile this C++ S-function, enter the following command in MATLAB:
+ *
+ *   >>make sfunFrameGain.cpp
+ *
+ * Then connect a frame-based source (e.g. a Buffer block) to the S-Function
+ * block.
+ */
+
+//------------------------------------------------------------------------------
+
+#define S_FUNCTION_NAME  sfunFrameGain
+
+enum inputPortName {
+    U
+};
+
+enum outputPortName {
+    Y
+};
+
+enum parameterName {
+    K
+};
+
+#include "EasyLink.h"
+
+//------------------------------------------------------------------------------
+
+class Block : public BaseBlock {
+public:
+
+    static void checkParametersSizes(SimStruct *S) {
+        assertParameterPortsCount(S, 1);
+        assertParameterPort(S, K, true, 1, 1, mxDOUBLE_CLASS);
+    }
+
+    static void initializeInputPortSizes(SimStruct *S) {
+        setInputPortsCount(S, 1);
+        setInputPort(S, U, -1, -1, SS_DOUBLE, true, PORT_FRAME_INHERITED);
+    }
+
+    static void initializeOutputPortSizes(SimStruct *S) {
+        setOutputPortsCount(S, 1);
+        setOutputPort(S, Y, -1, -1, SS_DOUBLE, PORT_FRAME_INHERITED);
+    }
+
+    static void initializeOptions(SimStruct *S) {
+        setRuntimeThreadSafe(S);
+    }
+
+    // Sample-based input
+    void outputs() {
+        double k = getParameterDouble(K);
+        const double *u = (const double*) getInputData(U);
+        double *y = (double*) getOutputData(Y);
+        for (int i = 0; i < getInputWidth(U); i++)
+            y[i] = k * u[i];
+    }
+
+    // Frame-based input: the samples of a channel are contiguous
+    void outputsFrame() {
+        double k = getParameterDouble(K);
+        int frameSize = getInputFrameSize(U);
+        for (int channel = 0; channel < getInputChannelsCount(U); channel++) {
+            const double *u = (const double*) getInputData(U) + channel * frameSize;
+            double *y = (double*) getOutputData(Y) + channel * frameSize;
+            for (int i = 0; i < frameSize; i++)
+                y[i] = k * u[i];
+        }
+    }
+
+};
+
+//------------------------------------------------------------------------------
+
+#include "sfunDefinitions.h"
+
+//------------------------------------------------------------------------------
@@ -23,13 +23,13 @@ enum inputPortName {
 class Block : public BaseBlock {
 public:
 
-    static void initializeInputPortSizes() {
-        setInputPortsCount(5);
-        setInputPort(IN1, 1, 1, SS_DOUBLE);
-        setInputPort(IN2, 3, 1, SS_DOUBLE);
-        setInputPort(IN3, 4, 2, SS_DOUBLE);
-        setInputPort(IN4, -1, 1, SS_DOUBLE);
-        setInputPort(IN5, -1, -1, SS_DOUBLE);
+    static void initializeInputPortSizes(SimStruct *S) {
+        setInputPortsCount(S, 5);
+        setInputPort(S, IN1, 1, 1, SS_DOUBLE);
+        setInputPort(S, IN2, 3, 1, SS_DOUBLE);
+        setInputPort(S, IN3, 4, 2, SS_DOUBLE);
+        setInputPort(S, IN4, -1, 1, SS_DOUBLE);
+        setInputPort(S, IN5, -1, -1, SS_DOUBLE);
     }
 
     void start() {
@@ -6,6 +6,9 @@
  *   >>make sfunMatlabArrays.cpp
  *
  * Then open the file "testMatlabArrays.mdl/slx" and start the simulation.
+ *
+ * The MATLAB workspace is only reachable in simulation: this S-function cannot
+ * be compiled into the generated code of a model.
  */
 
 //------------------------------------------------------------------------------
@@ -14,6 +17,10 @@
 
 #include "EasyLink.h"
 
+#ifndef MATLAB_MEX_FILE
+#error sfunMatlabArrays uses the MATLAB workspace and only compiles as a MEX file.
+#endif
+
 //------------------------------------------------------------------------------
 
 class Block : public BaseBlock {
@@ -0,0 +1,121 @@
+/* 
+ * This file illustrates how to construct a multi-rate C++ S-function with
+ * EasyLink.  The S-function has one scalar input and two scalar outputs.
+ * The fast rate removes the mean of the input from the input, the slow rate
+ * outputs the mean of the input,
+ *
+ *   y0 = u - mean(u)   (fast rate)
+ *   y1 = mean(u)       (slow rate)
+ *
+ * The mean is computed at the fast rate and passed to the slow rate through a
+ * RateTransitionBuffer, so that the block is safe in multitasking mode.
+ *
+ * To compile this C++ S-function, enter the following command in MATLAB:
+ *
+ *   >>make sfunMultiRate.cpp
+ *
+ * Then use it in a S-Function block with the parameters [0.0001, 0.1].
+ */
+
+//------------------------------------------------------------------------------
+
+#define S_FUNCTION_NAME  sfunMultiRate
+
+enum inputPortName {
+    U
+};
+
+enum outputPortName {
+    FAST, SLOW
+};
+
+enum parameterName {
+    FAST_PERIOD, SLOW_PERIOD
+};
+
+enum rateName {
+    FAST_RATE, SLOW_RATE
+};
+
+#include "EasyLink.h"
+
+//------------------------------------------------------------------------------
+
+class Block : public BaseBlock {
+public:
+
+    static void checkParametersSizes(SimStruct *S) {
+        assertParameterPortsCount(S, 2);
+        assertParameterPort(S, FAST_PERIOD, false, 1, 1, mxDOUBLE_CLASS);
+        assertParameterPort(S, SLOW_PERIOD, false, 1, 1, mxDOUBLE_CLASS);
+    }
+
+    static void initializeInputPortSizes(SimStruct *S) {
+        setInputPortsCount(S, 1);
+        setInputPort(S, U, 1, 1, SS_DOUBLE);
+    }
+
+    static void initializeOutputPortSizes(SimStruct *S) {
+        setOutputPortsCount(S, 2);
+        setOutputPort(S, FAST, 1, 1, SS_DOUBLE);
+        setOutputPort(S, SLOW, 1, 1, SS_DOUBLE);
+    }
+
+    static void initializeNumberSampleTimes(SimStruct *S) {
+        setSampleTimesCount(S, 2);
+    }
+
+    static void initializeSampleTimes(SimStruct *S) {
+        setSampleTime(S, FAST_RATE, getParameterDouble(S, FAST_PERIOD));
+        setSampleTime(S, SLOW_RATE, getParameterDouble(S, SLOW_PERIOD));
+    }
+
+    void start() {
+        sum = 0.0;
+        count = 0;
+        mean.resize(1);
+    }
+
+    void outputsForRate(int rate) {
+        if (rate == FAST_RATE) {
+            double average = count > 0 ? sum / count : 0.0;
+            setOutputDouble(FAST, getInputDouble(U) - average);
+        } else if (rate == SLOW_RATE) {
+            setOutputDouble(SLOW, mean.getReadData()[0]);
+        }
+    }
+
+    void updateForRate(int rate) {
+        if (rate == FAST_RATE) {
+            sum += getInputDouble(U);
+            count++;
+            mean.getWriteData()[0] = sum / count;
+            mean.publish();
+        }
+    }
+
+    // The mean is published again when the operating point is restored
+    void serializeState(SimStateBuffer &state) {
+        state.serialize(sum);
+        state.serialize(count);
+        if (state.isReading()) {
+            mean.getWriteData()[0] = count > 0 ? sum / count : 0.0;
+            mean.publish();
+        }
+    }
+
+private:
+
+    // Only used by the fast rate
+    double sum;
+    long count;
+
+    // Written by the fast rate, read by the slow rate
+    RateTransitionBuffer<double> mean;
+};
+
+//------------------------------------------------------------------------------
+
+#include "sfunDefinitions.h"
+
+//------------------------------------------------------------------------------
@@ -24,19 +24,25 @@
 class Block : public BaseBlock {
 public:
 
-    static void checkParametersSizes() {
-        assertParameterPortsCount(1);
-        assertParameterPort(0, true, 1, 1, mxDOUBLE_CLASS);
+    static void checkParametersSizes(SimStruct *S) {
+        assertParameterPortsCount(S, 1);
+        assertParameterPort(S, 0, true, 1, 1, mxDOUBLE_CLASS);
     }
 
-    static void initializeInputPortSizes() {
-        setInputPortsCount(1);
-        setInputPort(0, 1, 1, SS_DOUBLE);
+    static void initializeInputPortSizes(SimStruct *S) {
+        setInputPortsCount(S, 1);
+        setInputPort(S, 0, 1, 1, SS_DOUBLE);
     }
 
-    static void initializeOutputPortSizes() {
-        setOutputPortsCount(1);
-        setOutputPort(0, 1, 1, SS_DOUBLE);
+    static void initializeOutputPortSizes(SimStruct *S) {
+        setOutputPortsCount(S, 1);
+        setOutputPort(S, 0, 1, 1, SS_DOUBLE);
+    }
+
+    // The block only uses its own ports and parameters, so it can run in
+    // parallel with other blocks
+    static void initializeOptions(SimStruct *S) {
+        setRuntimeThreadSafe(S);
     }
 
     void start() {
@@ -23,11 +23,11 @@ enum outputPortName {
 class Block : public BaseBlock {
 public:
 
-    static void initializeOutputPortSizes() {
-        setOutputPortsCount(3);
-        setOutputPort(OUT1, 1, 1, SS_DOUBLE);
-        setOutputPort(OUT2, 3, 1, SS_DOUBLE);
-        setOutputPort(OUT3, 2, 3, SS_INT32);
+    static void initializeOutputPortSizes(SimStruct *S) {
+        setOutputPortsCount(S, 3);
+        setOutputPort(S, OUT1, 1, 1, SS_DOUBLE);
+        setOutputPort(S, OUT2, 3, 1, SS_DOUBLE);
+        setOutputPort(S, OUT3, 2, 3, SS_INT32);
     }
 
     void start() {
@@ -23,14 +23,14 @@ enum parameterName {
 class Block : public BaseBlock {
 public:
 
-    static void checkParametersSizes() {
-        assertParameterPortsCount(6);
-        assertParameterPort(PAR1, true, 1, 1, mxDOUBLE_CLASS);
-        assertParameterPort(PAR2, false, 2, 3, mxDOUBLE_CLASS);
-        assertParameterPort(PAR3, true, 1, -1, mxDOUBLE_CLASS);
-        assertParameterPort(PAR4, false, -1, -1, mxDOUBLE_CLASS);
-        assertParameterPort(PAR5, true, 1, -1, mxCHAR_CLASS);
-        assertParameterPort(PAR6, false, 1, -1, mxCHAR_CLASS);
+    static void checkParametersSizes(SimStruct *S) {
+        assertParameterPortsCount(S, 6);
+        assertParameterPort(S, PAR1, true, 1, 1, mxDOUBLE_CLASS);
+        assertParameterPort(S, PAR2, false, 2, 3, mxDOUBLE_CLASS);
+        assertParameterPort(S, PAR3, true, 1, -1, mxDOUBLE_CLASS);
+        assertParameterPort(S, PAR4, false, -1, -1, mxDOUBLE_CLASS);
+        assertParameterPort(S, PAR5, true, 1, -1, mxCHAR_CLASS);
+        assertParameterPort(S, PAR6, false, 1, -1, mxCHAR_CLASS);
     }
 
     void start() {
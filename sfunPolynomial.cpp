@@ -0,0 +1,87 @@
+//------------------------------------------------------------------------------
+/* C++ S-function for defining a polynomial with port-based sample times.
+ *
+ *    y = P(1) u^n + P(2) u^(n-1) + ... + P(n+1)
+ *
+ * The output takes the sample time of the input. When the input is constant,
+ * the output is computed once at initialization and Simulink folds the block
+ * out of the simulation loop.
+ *
+ * To compile this C++ S-function, enter the following command in MATLAB:
+ *
+ *   >>make sfunPolynomial.cpp
+ *
+ * Then run testPolynomial.m, which builds a test model with a constant and a
+ * sampled input and checks the sample times of the blocks.
+ */
+//------------------------------------------------------------------------------
+#define S_FUNCTION_NAME  sfunPolynomial
+
+enum inputPortName {
+    U
+};
+
+enum outputPortName {
+    Y
+};
+
+enum parameterName {
+    P
+};
+
+
+//------------------------------------------------------------------------------
+#include "EasyLink.h"
+
+
+//------------------------------------------------------------------------------
+
+class Block : public BaseBlock {
+public:
+
+    // A constant block cannot have tunable parameters
+    static void checkParametersSizes(SimStruct *S) {
+        assertParameterPortsCount(S, 1);
+        assertParameterPort(S, P, false, 1, -1, mxDOUBLE_CLASS);
+    }
+
+    static void initializeInputPortSizes(SimStruct *S) {
+        setInputPortsCount(S, 1);
+        setInputPort(S, U, -1, -1, SS_DOUBLE);
+    }
+
+    static void initializeOutputPortSizes(SimStruct *S) {
+        setOutputPortsCount(S, 1);
+        setOutputPort(S, Y, -1, -1, SS_DOUBLE);
+    }
+
+    static void initializeNumberSampleTimes(SimStruct *S) {
+        setPortBasedSampleTimes(S);
+    }
+
+    static void checkInputPortFinalSizes(SimStruct *S, int port, int nRows, int nCols) {
+        if (port == U) {
+            setOutputPortFinalSizes(S, Y, nRows, nCols);
+        }
+    }
+
+    void outputs() {
+        Array<double> u = getInputArray<double>(U);
+        Array<double> y = getOutputArray<double>(Y);
+        Array<double> p = getParameterArray<double>(P);
+
+        // Horner's method
+        for (int i = 0; i < u.getWidth(); i++) {
+            double value = p[0];
+            for (int k = 1; k < p.getWidth(); k++)
+                value = value * u[i] + p[k];
+            y[i] = value;
+        }
+    }
+
+};
+
+//------------------------------------------------------------------------------
+#include "sfunDefinitions.h"
+
+//------------------------------------------------------------------------------
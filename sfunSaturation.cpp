@@ -0,0 +1,122 @@
+//------------------------------------------------------------------------------
+/* C++ S-function for defining a saturation with zero-crossing detection.
+ *
+ *    y = min(max(u, lower), upper)
+ *
+ * The mode of each element (lower, linear or upper) only changes at major
+ * time steps and two zero-crossing signals per element let variable-step 
+ * solvers locate the instants where the saturation begins or ends.
+ *
+ * To compile this C++ S-function, enter the following command in MATLAB:
+ *
+ *   >>make sfunSaturation.cpp
+ *
+ * Then run testSaturation.m, which builds a test model and checks that a
+ * variable-step simulation locates the zero crossings.
+ */
+//------------------------------------------------------------------------------
+#define S_FUNCTION_NAME  sfunSaturation
+
+enum inputPortName {
+    U
+};
+
+enum outputPortName {
+    Y
+};
+
+enum parameterName {
+    LOWER, UPPER
+};
+
+enum modeName {
+    LOWER_MODE, LINEAR_MODE, UPPER_MODE
+};
+
+
+//------------------------------------------------------------------------------
+#include "EasyLink.h"
+
+
+//------------------------------------------------------------------------------
+
+class Block : public BaseBlock {
+public:
+
+    static void checkParametersSizes(SimStruct *S) {
+        assertParameterPortsCount(S, 2);
+        assertParameterPort(S, LOWER, true, 1, 1, mxDOUBLE_CLASS);
+        assertParameterPort(S, UPPER, true, 1, 1, mxDOUBLE_CLASS);
+    }
+
+    static void initializeInputPortSizes(SimStruct *S) {
+        setInputPortsCount(S, 1);
+        setInputPort(S, U, 4, 1, SS_DOUBLE);
+    }
+
+    static void initializeOutputPortSizes(SimStruct *S) {
+        setOutputPortsCount(S, 1);
+        setOutputPort(S, Y, 4, 1, SS_DOUBLE);
+    }
+
+    // One mode and two zero crossings per element
+    static void initializeStatePortSizes(SimStruct *S) {
+        setContinuousStatesWidth(S, 0);
+        setDiscreteStatesWidth(S, 0);
+        setModesCount(S, 4);
+        setZeroCrossingsCount(S, 8);
+    }
+
+    static void initializeSampleTimes(SimStruct *S) {
+        ssSetSampleTime(S, 0, CONTINUOUS_SAMPLE_TIME);
+        ssSetOffsetTime(S, 0, 0.0);
+    }
+
+    // Called at major time steps only
+    void updateModes() {
+        Array<double> u = getInputArray<double>(U);
+        double lower = getParameterDouble(LOWER);
+        double upper = getParameterDouble(UPPER);
+
+        for (int i = 0; i < u.getWidth(); i++) {
+            if (u[i] <= lower)
+                setMode(i, LOWER_MODE);
+            else if (u[i] >= upper)
+                setMode(i, UPPER_MODE);
+            else
+                setMode(i, LINEAR_MODE);
+        }
+    }
+
+    // The outputs follow the modes, even if u crosses a limit in a minor step
+    void outputs() {
+        Array<double> u = getInputArray<double>(U);
+        Array<double> y = getOutputArray<double>(Y);
+
+        for (int i = 0; i < u.getWidth(); i++) {
+            switch (getMode(i)) {
+                case LOWER_MODE: y[i] = getParameterDouble(LOWER);
+                    break;
+                case UPPER_MODE: y[i] = getParameterDouble(UPPER);
+                    break;
+                default: y[i] = u[i];
+            }
+        }
+    }
+
+    void zeroCrossings() {
+        Array<double> u = getInputArray<double>(U);
+        Array<double> zc = getZeroCrossingsArray();
+
+        for (int i = 0; i < u.getWidth(); i++) {
+            zc[2 * i] = u[i] - getParameterDouble(LOWER);
+            zc[2 * i + 1] = u[i] - getParameterDouble(UPPER);
+        }
+    }
+
+};
+
+//------------------------------------------------------------------------------
+#include "sfunDefinitions.h"
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,93 @@
+//------------------------------------------------------------------------------
+/* C++ S-function for defining an event-driven block with a variable sample 
+ * time.
+ *
+ * The block outputs VALUES(i) from time TIMES(i). It runs only at the times of
+ * its events, returned by timeOfNextHit, instead of polling at a fixed rate.
+ *
+ * To compile this C++ S-function, enter the following command in MATLAB:
+ *
+ *   >>make sfunScheduledEvents.cpp
+ *
+ * Then run testScheduledEvents.m, which builds a test model and checks the
+ * order of the events and the restore of the pending events.
+ */
+//------------------------------------------------------------------------------
+#define S_FUNCTION_NAME  sfunScheduledEvents
+
+enum outputPortName {
+    Y
+};
+
+enum parameterName {
+    TIMES, VALUES
+};
+
+
+//------------------------------------------------------------------------------
+#include "EasyLink.h"
+
+
+//------------------------------------------------------------------------------
+
+class Block : public BaseBlock {
+public:
+
+    static void checkParametersSizes(SimStruct *S) {
+        assertParameterPortsCount(S, 2);
+        assertParameterPort(S, TIMES, false, -1, 1, mxDOUBLE_CLASS);
+        assertParameterPort(S, VALUES, false, -1, 1, mxDOUBLE_CLASS);
+        if (getParameterWidth(S, TIMES) != getParameterWidth(S, VALUES))
+            throw std::runtime_error("TIMES and VALUES must have the same number of elements.");
+    }
+
+    static void initializeInputPortSizes(SimStruct *S) {
+        setInputPortsCount(S, 0);
+    }
+
+    static void initializeOutputPortSizes(SimStruct *S) {
+        setOutputPortsCount(S, 1);
+        setOutputPort(S, Y, 1, 1, SS_DOUBLE);
+    }
+
+    static void initializeSampleTimes(SimStruct *S) {
+        setVariableSampleTime(S);
+    }
+
+    // All the events are scheduled before the simulation runs
+    void start() {
+        Array<double> times = getParameterArray<double>(TIMES);
+        Array<double> values = getParameterArray<double>(VALUES);
+
+        events.reserve(times.getWidth());
+        for (int i = 0; i < times.getWidth(); i++)
+            events.schedule(times[i], values[i]);
+        setOutputDouble(Y, 0.0);
+    }
+
+    void outputs() {
+        while (events.isDue(getSimulationTime()))
+            setOutputDouble(Y, events.pop());
+    }
+
+    double timeOfNextHit() {
+        return events.getNextTime(getStopTime());
+    }
+
+    // The pending events and the output held since the last event are saved
+    // with the operating point of the model
+    void serializeState(SimStateBuffer &state) {
+        state.serialize(events);
+        state.serialize(*(double*) getOutputData(Y));
+    }
+
+private:
+
+    EventQueue<double> events;
+
+};
+
+//------------------------------------------------------------------------------
+#include "sfunDefinitions.h"
+
+//------------------------------------------------------------------------------
@@ -22,20 +22,20 @@
 class Block : public BaseBlock {
 public:
 
-    static void checkParametersSizes() {
-        assertParameterPortsCount(1);
-        assertParameterPort(0, false, 1, 1, mxINT32_CLASS);
+    static void checkParametersSizes(SimStruct *S) {
+        assertParameterPortsCount(S, 1);
+        assertParameterPort(S, 0, false, 1, 1, mxINT32_CLASS);
     }
 
-    static void initializeInputPortSizes() {
-        setInputPortsCount(1);
-        setInputPort(0, 1, 1, SS_DOUBLE);
+    static void initializeInputPortSizes(SimStruct *S) {
+        setInputPortsCount(S, 1);
+        setInputPort(S, 0, 1, 1, SS_DOUBLE);
     }
 
-    static void initializeOutputPortSizes() {
-        setOutputPortsCount(1);
-        int nRows = getParameterScalar<int>(0);
-        setOutputPort(0, 1, nRows, SS_DOUBLE);
+    static void initializeOutputPortSizes(SimStruct *S) {
+        setOutputPortsCount(S, 1);
+        int nRows = getParameterScalar<int>(S, 0);
+        setOutputPort(S, 0, 1, nRows, SS_DOUBLE);
     }
 
     void outputs() {
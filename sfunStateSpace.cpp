@@ -25,78 +25,113 @@ enum parameterName {
     A, B, C, D
 };
 
+enum dworkName {
+    A_MATRIX, B_MATRIX, C_MATRIX, D_MATRIX
+};
+
 
 //------------------------------------------------------------------------------
 #include "EasyLink.h"
-
-#include <Eigen/Dense>
-
-#define EIGEN_INPUT_MATRIX(type, name, port) Eigen::Map<Eigen::Matrix<type, Eigen::Dynamic, Eigen::Dynamic> > name((type*)getInputData(port), getInputNRows(port), getInputNCols(port))
-#define EIGEN_OUTPUT_MATRIX(type, name, port) Eigen::Map<Eigen::Matrix<type, Eigen::Dynamic, Eigen::Dynamic> > name((type*)getOutputData(port), getOutputNRows(port), getOutputNCols(port))
-#define EIGEN_PARAMETER_MATRIX(type, name, port) name= Eigen::Map<Eigen::Matrix<type, Eigen::Dynamic, Eigen::Dynamic> >((type*)getParameterData(port), getParameterNRows(port), getParameterNCols(port))
-#define EIGEN_STATE_MATRIX(type, name) Eigen::Map<Eigen::Matrix<type, Eigen::Dynamic, Eigen::Dynamic> > name((type*)getContinuousStateData(), getContinuousStateWidth(), 1)
-#define EIGEN_DERIVATIVE_STATE_MATRIX(type, name) Eigen::Map<Eigen::Matrix<type, Eigen::Dynamic, Eigen::Dynamic> > name((type*)getDerivativeStateData(), getContinuousStateWidth(), 1)
+#include "EigenBridge.h"
 
 
 //------------------------------------------------------------------------------
 
 class Block : public BaseBlock {
-private:
-
-    Eigen::MatrixXd a, b, c, d;
-
 public:
 
-    static void checkParametersSizes() {
-        assertParameterPortsCount(4);
-        assertParameterPort(A, false, -1, -1, mxDOUBLE_CLASS);
-        assertParameterPort(B, false, -1, -1, mxDOUBLE_CLASS);
-        assertParameterPort(C, false, -1, -1, mxDOUBLE_CLASS);
-        assertParameterPort(D, false, -1, -1, mxDOUBLE_CLASS);
+    static void checkParametersSizes(SimStruct *S) {
+        assertParameterPortsCount(S, 4);
+        assertParameterPort(S, A, true, -1, -1, mxDOUBLE_CLASS);
+        assertParameterPort(S, B, true, -1, -1, mxDOUBLE_CLASS);
+        assertParameterPort(S, C, true, -1, -1, mxDOUBLE_CLASS);
+        assertParameterPort(S, D, true, -1, -1, mxDOUBLE_CLASS);
     }
 
-    static void initializeInputPortSizes() {
-        setInputPortsCount(1);
-        setInputPort(U, getParameterNCols(B), 1, SS_DOUBLE);
+    static void initializeInputPortSizes(SimStruct *S) {
+        setInputPortsCount(S, 1);
+        setInputPort(S, U, getParameterNCols(S, B), 1, SS_DOUBLE);
     }
 
-    static void initializeOutputPortSizes() {
-        setOutputPortsCount(1);
-        setOutputPort(Y, getParameterNRows(C), 1, SS_DOUBLE);
+    static void initializeOutputPortSizes(SimStruct *S) {
+        setOutputPortsCount(S, 1);
+        setOutputPort(S, Y, getParameterNRows(S, C), 1, SS_DOUBLE);
     }
 
-    static void initializeStatePortSizes() {
-        setContinuousStatesWidth(getParameterNCols(A));
-        setDiscreteStatesWidth(0);
+    static void initializeStatePortSizes(SimStruct *S) {
+        setContinuousStatesWidth(S, getParameterNCols(S, A));
+        setDiscreteStatesWidth(S, 0);
+        // The Jacobian [A B; C D] is dense
+        int nRows = getParameterNCols(S, A) + getParameterNRows(S, C);
+        int nCols = getParameterNCols(S, A) + getParameterNCols(S, B);
+        setJacobianNzMax(S, nRows * nCols);
     }
 
-    static void initializeSampleTimes() {
-        ssSetSampleTime(simStruct, 0, CONTINUOUS_SAMPLE_TIME);
-        ssSetOffsetTime(simStruct, 0, 0.0);
-        //        ssSetModelReferenceSampleTimeDefaultInheritance(simStruct);
+    static void initializeSampleTimes(SimStruct *S) {
+        ssSetSampleTime(S, 0, CONTINUOUS_SAMPLE_TIME);
+        ssSetOffsetTime(S, 0, 0.0);
+        //        ssSetModelReferenceSampleTimeDefaultInheritance(S);
+    }
+
+    // The matrices are stored in DWorks, allocated by Simulink
+    static void initializeWorkVectors(SimStruct *S) {
+        setDWorksCount(S, 4);
+        setDWork(S, A_MATRIX, getParameterWidth(S, A), SS_DOUBLE, "A");
+        setDWork(S, B_MATRIX, getParameterWidth(S, B), SS_DOUBLE, "B");
+        setDWork(S, C_MATRIX, getParameterWidth(S, C), SS_DOUBLE, "C");
+        setDWork(S, D_MATRIX, getParameterWidth(S, D), SS_DOUBLE, "D");
     }
 
     void start() {
-        EIGEN_PARAMETER_MATRIX(double, a, A);
-        EIGEN_PARAMETER_MATRIX(double, b, B);
-        EIGEN_PARAMETER_MATRIX(double, c, C);
-        EIGEN_PARAMETER_MATRIX(double, d, D);
+        setJacobianDense();
+    }
+
+    // The matrices are tunable: only the tuned ones are copied again
+    void processParameters() {
+        if (parameterChanged(A))
+            getDWorkMap<MatrixMap<double> >(A_MATRIX, getParameterNRows(A)) = getParameterMap<ConstMatrixMap<double> >(A);
+        if (parameterChanged(B))
+            getDWorkMap<MatrixMap<double> >(B_MATRIX, getParameterNRows(B)) = getParameterMap<ConstMatrixMap<double> >(B);
+        if (parameterChanged(C))
+            getDWorkMap<MatrixMap<double> >(C_MATRIX, getParameterNRows(C)) = getParameterMap<ConstMatrixMap<double> >(C);
+        if (parameterChanged(D))
+            getDWorkMap<MatrixMap<double> >(D_MATRIX, getParameterNRows(D)) = getParameterMap<ConstMatrixMap<double> >(D);
     }
 
     void outputs() {
-        EIGEN_INPUT_MATRIX(double, u, U);
-        EIGEN_OUTPUT_MATRIX(double, y, Y);
-        EIGEN_STATE_MATRIX(double, x);
-        
-        y = c * x + d*u;
+        ConstMatrixMap<double> c = getDWorkMap<ConstMatrixMap<double> >(C_MATRIX, getOutputWidth(Y));
+        ConstMatrixMap<double> d = getDWorkMap<ConstMatrixMap<double> >(D_MATRIX, getOutputWidth(Y));
+        ConstMatrixMap<double> u = getInputMap<ConstMatrixMap<double> >(U);
+        MatrixMap<double> y = getOutputMap<MatrixMap<double> >(Y);
+        ConstMatrixMap<double> x = getContinuousStateMap<ConstMatrixMap<double> >();
+
+        // noalias avoids the temporaries (and heap allocations) of the products
+        y.noalias() = c * x;
+        y.noalias() += d * u;
     }
 
     void derivatives() {
-        EIGEN_INPUT_MATRIX(double, u, U);
-        EIGEN_STATE_MATRIX(double, x);
-        EIGEN_DERIVATIVE_STATE_MATRIX(double, dx);
+        ConstMatrixMap<double> a = getDWorkMap<ConstMatrixMap<double> >(A_MATRIX, getContinuousStateWidth());
+        ConstMatrixMap<double> b = getDWorkMap<ConstMatrixMap<double> >(B_MATRIX, getContinuousStateWidth());
+        ConstMatrixMap<double> u = getInputMap<ConstMatrixMap<double> >(U);
+        ConstMatrixMap<double> x = getContinuousStateMap<ConstMatrixMap<double> >();
+        MatrixMap<double> dx = getDerivativeStateMap<MatrixMap<double> >();
+
+        dx.noalias() = a * x;
+        dx.noalias() += b * u;
+    }
 
-        dx = a * x + b*u;
+    // Stiff solvers use the Jacobian instead of finite differences
+    void jacobian() {
+        int nx = getContinuousStateWidth();
+        int ny = getOutputWidth(Y);
+        int nu = getInputWidth(U);
+        MatrixMap<double> j = getJacobianMap<MatrixMap<double> >();
+
+        j.topLeftCorner(nx, nx) = getDWorkMap<ConstMatrixMap<double> >(A_MATRIX, nx);
+        j.topRightCorner(nx, nu) = getDWorkMap<ConstMatrixMap<double> >(B_MATRIX, nx);
+        j.bottomLeftCorner(ny, nx) = getDWorkMap<ConstMatrixMap<double> >(C_MATRIX, ny);
+        j.bottomRightCorner(ny, nu) = getDWorkMap<ConstMatrixMap<double> >(D_MATRIX, ny);
     }
 
 };
@@ -0,0 +1,56 @@
+/* 
+ * This file illustrates how to read a non-contiguous input port with
+ * EasyLink.  The S-function outputs the sum of the elements of its input,
+ *
+ *   y = sum(u)
+ *
+ * The input port accepts scattered elements (for instance from a Mux block),
+ * so Simulink does not copy them to a contiguous buffer at each time step.
+ * The elements are read through a view of the port.
+ *
+ * To compile this C++ S-function, enter the following command in MATLAB:
+ *
+ *   >>make sfunSum.cpp
+ */
+
+//------------------------------------------------------------------------------
+
+#define S_FUNCTION_NAME  sfunSum
+
+#include "EasyLink.h"
+
+//------------------------------------------------------------------------------
+
+class Block : public BaseBlock {
+public:
+
+    static void initializeInputPortSizes(SimStruct *S) {
+        setInputPortsCount(S, 1);
+        setInputPort(S, 0, -1, 1, SS_DOUBLE, true, PORT_NON_CONTIGUOUS);
+    }
+
+    static void initializeOutputPortSizes(SimStruct *S) {
+        setOutputPortsCount(S, 1);
+        setOutputPort(S, 0, 1, 1, SS_DOUBLE);
+    }
+
+    static void initializeOptions(SimStruct *S) {
+        setRuntimeThreadSafe(S);
+    }
+
+    void outputs() {
+        InputPortView<double> u = getInputView<double>(0);
+
+        double sum = 0.0;
+        for (InputPortView<double>::Iterator it = u.begin(); it != u.end(); ++it)
+            sum += *it;
+        setOutputDouble(0, sum);
+    }
+
+};
+
+//------------------------------------------------------------------------------
+
+#include "sfunDefinitions.h"
+
+//------------------------------------------------------------------------------
@@ -23,26 +23,30 @@
 class Block : public BaseBlock {
 public:
 
-    static void initializeInputPortSizes() {
-        setInputPortsCount(1);
-        setInputPort(0, -1, -1, SS_DOUBLE);
+    static void initializeInputPortSizes(SimStruct *S) {
+        setInputPortsCount(S, 1);
+        setInputPort(S, 0, -1, -1, SS_DOUBLE);
     }
 
-    static void initializeOutputPortSizes() {
-        setOutputPortsCount(1);
-        setOutputPort(0, -1, -1, SS_DOUBLE);
+    static void initializeOutputPortSizes(SimStruct *S) {
+        setOutputPortsCount(S, 1);
+        setOutputPort(S, 0, -1, -1, SS_DOUBLE);
     }
 
-    static void checkInputPortFinalSizes(int port, int nRows, int nCols) {
+    // The output can reuse the buffer of the input
+    static void initializeOptions(SimStruct *S) {
+        setInPlacePair(S, 0, 0);
+    }
+
+    static void checkInputPortFinalSizes(SimStruct *S, int port, int nRows, int nCols) {
         if (port == 0) {
-            setOutputPortFinalSizes(0, nRows, nCols);
+            setOutputPortFinalSizes(S, 0, nRows, nCols);
         }
     }
 
     void outputs() {
-        Array<double> in = getInputArray<double>(0);
-        Array<double> out = getOutputArray<double>(0);
-        out = in * 2.0;
+        Array<double> out = getInPlaceArray<double>(0, 0);
+        out *= 2.0;
     }
 
 };
@@ -17,39 +17,32 @@
 #define S_FUNCTION_NAME  sfunTimesTwoWithEigen
 
 #include "EasyLink.h"
-
-#include <Eigen/Dense>
-
-#define EIGEN_INPUT_MATRIX(type, name, port) Eigen::Map<Eigen::Matrix<type, Eigen::Dynamic, Eigen::Dynamic> > name((type*)getInputData(port), getInputNRows(port), getInputNCols(port))
-#define EIGEN_INPUT_ARRAY(type, name, port) Eigen::Map<Eigen::Array<type, Eigen::Dynamic, Eigen::Dynamic> > name((type*)getInputData(port), getInputNRows(port), getInputNCols(port))
-#define EIGEN_OUTPUT_MATRIX(type, name, port) Eigen::Map<Eigen::Matrix<type, Eigen::Dynamic, Eigen::Dynamic> > name((type*)getOutputData(port), getOutputNRows(port), getOutputNCols(port))
-#define EIGEN_OUTPUT_ARRAY(type, name, port) Eigen::Map<Eigen::Array<type, Eigen::Dynamic, Eigen::Dynamic> > name((type*)getOutputData(port), getOutputNRows(port), getOutputNCols(port))
-
+#include "EigenBridge.h"
 
 //------------------------------------------------------------------------------
 
 class Block : public BaseBlock {
 public:
 
-    static void initializeInputPortSizes() {
-        setInputPortsCount(1);
-        setInputPort(0, -1, -1, SS_DOUBLE);
+    static void initializeInputPortSizes(SimStruct *S) {
+        setInputPortsCount(S, 1);
+        setInputPort(S, 0, -1, -1, SS_DOUBLE);
     }
 
-    static void initializeOutputPortSizes() {
-        setOutputPortsCount(1);
-        setOutputPort(0, -1, -1, SS_DOUBLE);
+    static void initializeOutputPortSizes(SimStruct *S) {
+        setOutputPortsCount(S, 1);
+        setOutputPort(S, 0, -1, -1, SS_DOUBLE);
     }
 
-    static void checkInputPortFinalSizes(int port, int nRows, int nCols) {
+    static void checkInputPortFinalSizes(SimStruct *S, int port, int nRows, int nCols) {
         if (port == 0) {
-            setOutputPortFinalSizes(0, nRows, nCols);
+            setOutputPortFinalSizes(S, 0, nRows, nCols);
         }
     }
 
     void outputs() {
-        EIGEN_INPUT_ARRAY(double, in, 0);
-        EIGEN_OUTPUT_ARRAY(double, out, 0);
+        ConstArrayMap<double> in = getInputMap<ConstArrayMap<double> >(0);
+        ArrayMap<double> out = getOutputMap<ArrayMap<double> >(0);
         out = in * 2.0;
     }
 
@@ -0,0 +1,59 @@
+/* 
+ * C++ S-function for multiplying a 3-element input by a gain, with ports and
+ * parameters declared by port lists.
+ *
+ *   y = k*u
+ *
+ * The sizes of the ports and the parameter are checked by TypedBlock, and
+ * the accessors in, out and param are checked at compile time.
+ *
+ * To compile this C++ S-function, enter the following command in MATLAB:
+ *
+ *   >>make sfunTypedGain.cpp
+ *
+ * Then use it in a S-function block with one parameter (the gain).
+ */
+
+//------------------------------------------------------------------------------
+
+#define S_FUNCTION_NAME  sfunTypedGain
+
+enum inputPortName {
+    U
+};
+
+enum outputPortName {
+    Y
+};
+
+enum parameterName {
+    K
+};
+
+#include "EasyLink.h"
+
+//------------------------------------------------------------------------------
+
+typedef PortList<InputPort<U, double, 3> > Inputs;
+typedef PortList<OutputPort<Y, double, 3> > Outputs;
+typedef PortList<ParameterPort<K, double, 1, 1, true> > Parameters;
+
+class Block : public TypedBlock<Inputs, Outputs, Parameters> {
+public:
+
+    void outputs() {
+        PortAt<U, Inputs>::type::View u = in<U>();
+        PortAt<Y, Outputs>::type::View y = out<Y>();
+        double k = param<K>()[0];
+
+        for (int i = 0; i < y.getWidth(); i++)
+            y[i] = k * u[i];
+    }
+
+};
+
+//------------------------------------------------------------------------------
+
+#include "sfunDefinitions.h"
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,119 @@
+//------------------------------------------------------------------------------
+/* C++ S-function for defining a nonlinear continuous system whose Jacobian is
+ * computed by automatic differentiation (Van der Pol oscillator).
+ *
+ *    x1' = x2
+ *    x2' = mu (1 - x1^2) x2 - x1 + u
+ *    y   = x
+ *
+ * The model is written once as a template: it is evaluated with doubles for 
+ * the outputs and the derivatives, and with dual numbers for the Jacobian used
+ * by stiff solvers (ode15s, ode23t...).
+ *
+ * To compile this C++ S-function, enter the following command in MATLAB:
+ *
+ *   >>make sfunVanDerPol.cpp
+ *
+ * Then run testVanDerPol.m, which builds a test model, checks the Jacobian
+ * against the analytic one and simulates the model with ode15s.
+ */
+//------------------------------------------------------------------------------
+#define S_FUNCTION_NAME  sfunVanDerPol
+
+enum inputPortName {
+    U
+};
+
+enum outputPortName {
+    Y
+};
+
+enum parameterName {
+    MU
+};
+
+
+//------------------------------------------------------------------------------
+#include "EasyLink.h"
+
+
+//------------------------------------------------------------------------------
+
+struct VanDerPol {
+    double mu;
+
+    template<typename T>
+    void operator()(const T *x, const T *u, T *dx, T *y) const {
+        dx[0] = x[1];
+        dx[1] = mu * (1.0 - x[0] * x[0]) * x[1] - x[0] + u[0];
+        y[0] = x[0];
+        y[1] = x[1];
+    }
+};
+
+class Block : public BaseBlock {
+public:
+
+    static void checkParametersSizes(SimStruct *S) {
+        assertParameterPortsCount(S, 1);
+        assertParameterPort(S, MU, true, 1, 1, mxDOUBLE_CLASS);
+    }
+
+    static void initializeInputPortSizes(SimStruct *S) {
+        setInputPortsCount(S, 1);
+        setInputPort(S, U, 1, 1, SS_DOUBLE, false);
+    }
+
+    static void initializeOutputPortSizes(SimStruct *S) {
+        setOutputPortsCount(S, 1);
+        setOutputPort(S, Y, 2, 1, SS_DOUBLE);
+    }
+
+    static void initializeStatePortSizes(SimStruct *S) {
+        setContinuousStatesWidth(S, 2);
+        setDiscreteStatesWidth(S, 0);
+        setJacobianNzMax(S, 6);
+    }
+
+    static void initializeSampleTimes(SimStruct *S) {
+        ssSetSampleTime(S, 0, CONTINUOUS_SAMPLE_TIME);
+        ssSetOffsetTime(S, 0, 0.0);
+    }
+
+    void start() {
+        double *x = getContinuousStateData();
+        x[0] = 2.0;
+        x[1] = 0.0;
+
+        // Rows: x1', x2', y1, y2. Cols: x1, x2, u.
+        Array<bool> pattern(4, 3, "Jacobian pattern");
+        pattern(1, 0) = pattern(2, 0) = true;
+        pattern(0, 1) = pattern(1, 1) = pattern(3, 1) = true;
+        pattern(1, 2) = true;
+        setJacobianMask(pattern);
+    }
+
+    void outputs() {
+        double dx[2];
+        VanDerPol model = {getParameterDouble(MU)};
+        model(getContinuousStateData(), (const double*) getInputData(U), dx, (double*) getOutputData(Y));
+    }
+
+    void derivatives() {
+        double y[2];
+        VanDerPol model = {getParameterDouble(MU)};
+        model(getContinuousStateData(), (const double*) getInputData(U), getDerivativeStateData(), y);
+    }
+
+    // The 3 columns of the Jacobian are differentiated in a single evaluation
+    void jacobian() {
+        VanDerPol model = {getParameterDouble(MU)};
+        differentiateJacobian<4>(model);
+    }
+
+};
+
+//------------------------------------------------------------------------------
+#include "sfunDefinitions.h"
+
+//------------------------------------------------------------------------------
@@ -0,0 +1,75 @@
+/* 
+ * This file illustrates how to process variable-size signals with EasyLink.
+ * The S-function outputs the positive elements of its input,
+ *
+ *   y = u(u > 0)
+ *
+ * The input and the output are variable-size vectors of at most n elements
+ * (parameter). Only the current elements of the input are read, and the 
+ * current size of the output is the number of positive elements.
+ *
+ * To compile this C++ S-function, enter the following command in MATLAB:
+ *
+ *   >>make sfunVariableSize.cpp
+ *
+ * Then connect a variable-size signal to the S-Function block.
+ */
+
+//------------------------------------------------------------------------------
+
+#define S_FUNCTION_NAME  sfunVariableSize
+
+enum inputPortName {
+    U
+};
+
+enum outputPortName {
+    Y
+};
+
+enum parameterName {
+    N
+};
+
+#include "EasyLink.h"
+
+//------------------------------------------------------------------------------
+
+class Block : public BaseBlock {
+public:
+
+    static void checkParametersSizes(SimStruct *S) {
+        assertParameterPortsCount(S, 1);
+        assertParameterPort(S, N, false, 1, 1, mxDOUBLE_CLASS);
+    }
+
+    static void initializeInputPortSizes(SimStruct *S) {
+        setInputPortsCount(S, 1);
+        setInputPort(S, U, (int) getParameterDouble(S, N), 1, SS_DOUBLE, true, PORT_VARIABLE_SIZE);
+    }
+
+    static void initializeOutputPortSizes(SimStruct *S) {
+        setOutputPortsCount(S, 1);
+        setOutputPort(S, Y, (int) getParameterDouble(S, N), 1, SS_DOUBLE, PORT_VARIABLE_SIZE);
+    }
+
+    void outputs() {
+        // Current size of the input, not the maximum size
+        int width = getInputWidth(U);
+        const double *u = (const double*) getInputData(U);
+        double *y = (double*) getOutputData(Y);
+
+        int count = 0;
+        for (int i = 0; i < width; i++)
+            if (u[i] > 0)
+                y[count++] = u[i];
+        setOutputCurrentSizes(Y, count);
+    }
+
+};
+
+//------------------------------------------------------------------------------
+
+#include "sfunDefinitions.h"
+
+//------------------------------------------------------------------------------
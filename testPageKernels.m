@@ -0,0 +1,27 @@
+function testPageKernels
+% TESTPAGEKERNELS Checks every page of mexPageSolve on multi-threaded stacks
+%
+% The stacks have page counts that are not multiples of the number of threads
+% times PAGE_LANES, so that the last chunk of pages is partial. mexPageSolve is
+% compiled with 4 threads to use the multi-threaded path on any machine.
+%
+% TESTPAGEKERNELS is part of EasyLink Library.
+% Copyright(c) 2014 FEMTO-ST, ENSMM, UFC, CNRS.
+
+make('mexPageSolve.cpp', '', '-DPAGE_THREADS=4');
+
+for nPages = [24577 32771 40961]
+    n = 3;
+    a = rand(n, n, nPages) + repmat(n * eye(n), [1 1 nPages]);
+    b = rand(n, 2, nPages);
+    x = mexPageSolve(a, b);
+    for p = 1:nPages
+        expected = a(:, :, p) \ b(:, :, p);
+        if max(max(abs(x(:, :, p) - expected))) > 1e-10
+            error('testPageKernels:wrongPage', 'Page %d of %d is wrong.', p, nPages);
+        end
+    end
+end
+
+make('mexPageSolve.cpp');
+disp('testPageKernels: all the pages are correct.');
@@ -0,0 +1,56 @@
+function testPolynomial
+% TESTPOLYNOMIAL Checks the port-based sample times of sfunPolynomial
+%
+% The test builds a model with two sfunPolynomial blocks computing u^2 - 1: 
+% one fed by a constant input, one fed by a sine wave sampled every 0.1 s.
+% The compiled sample time of each block must be the sample time of its input
+% (Inf for the constant one) and the outputs must be the polynomial of the 
+% inputs.
+%
+% TESTPOLYNOMIAL is part of EasyLink Library.
+% Copyright(c) 2014 FEMTO-ST, ENSMM, UFC, CNRS.
+
+make('sfunPolynomial.cpp');
+
+model = 'testPolynomial';
+if bdIsLoaded(model)
+    close_system(model, 0);
+end
+new_system(model);
+cleanup = onCleanup(@() close_system(model, 0));
+add_block('simulink/Sources/Constant', [model '/Constant'], 'Value', '2', 'SampleTime', 'inf');
+add_block('simulink/User-Defined Functions/S-Function', [model '/Constant polynomial'], ...
+    'FunctionName', 'sfunPolynomial', 'Parameters', '[1 0 -1]');
+add_block('simulink/Sinks/Out1', [model '/y1']);
+add_line(model, 'Constant/1', 'Constant polynomial/1');
+add_line(model, 'Constant polynomial/1', 'y1/1');
+add_block('simulink/Sources/Sine Wave', [model '/Sine'], 'SampleTime', '0.1');
+add_block('simulink/User-Defined Functions/S-Function', [model '/Sampled polynomial'], ...
+    'FunctionName', 'sfunPolynomial', 'Parameters', '[1 0 -1]');
+add_block('simulink/Sinks/Out1', [model '/y2']);
+add_line(model, 'Sine/1', 'Sampled polynomial/1');
+add_line(model, 'Sampled polynomial/1', 'y2/1');
+
+feval(model, [], [], [], 'compile');
+constantSampleTime = get_param([model '/Constant polynomial'], 'CompiledSampleTime');
+sampledSampleTime = get_param([model '/Sampled polynomial'], 'CompiledSampleTime');
+feval(model, [], [], [], 'term');
+if ~isequal(constantSampleTime, [Inf 0])
+    error('testPolynomial:wrongSampleTime', 'The block with a constant input is not constant.');
+end
+if ~isequal(sampledSampleTime, [0.1 0])
+    error('testPolynomial:wrongSampleTime', 'The block with a sampled input does not have the sample time of its input.');
+end
+
+simOut = sim(model, 'StopTime', '2', 'SaveTime', 'on', 'SaveOutput', 'on', 'SaveFormat', 'Array');
+t = simOut.get('tout');
+y = simOut.get('yout');
+if any(y(:, 1) ~= 3)
+    error('testPolynomial:wrongOutput', 'The output of the constant block is not 3.');
+end
+hits = abs(t / 0.1 - round(t / 0.1)) < 1e-9;
+if max(abs(y(hits, 2) - (sin(t(hits)).^2 - 1))) > 1e-12
+    error('testPolynomial:wrongOutput', 'The output of the sampled block is not the polynomial of its input.');
+end
+
+disp('testPolynomial: the sample times and the outputs are correct.');
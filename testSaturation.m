@@ -0,0 +1,51 @@
+function testSaturation
+% TESTSATURATION Checks the zero crossings and the modes of sfunSaturation
+%
+% The test builds a model where sine waves of amplitudes 2, 1.5, 3 and 0.5 drive
+% the sfunSaturation block (limits -1 and 1), and simulates it with a 
+% variable-step solver and a large maximum step. The solver must stop at each
+% instant where a sine wave crosses a limit, located by the zero crossings of
+% the block, and the output must equal the saturated input at every step.
+%
+% TESTSATURATION is part of EasyLink Library.
+% Copyright(c) 2014 FEMTO-ST, ENSMM, UFC, CNRS.
+
+make('sfunSaturation.cpp');
+
+amplitudes = [2 1.5 3 0.5];
+model = 'testSaturation';
+if bdIsLoaded(model)
+    close_system(model, 0);
+end
+new_system(model);
+cleanup = onCleanup(@() close_system(model, 0));
+add_block('simulink/Sources/Sine Wave', [model '/u'], ...
+    'Amplitude', mat2str(amplitudes), 'Frequency', '1', 'Phase', '0', 'Bias', '0', 'SampleTime', '0');
+add_block('simulink/User-Defined Functions/S-Function', [model '/Saturation'], ...
+    'FunctionName', 'sfunSaturation', 'Parameters', '-1, 1');
+add_block('simulink/Sinks/Out1', [model '/y']);
+add_line(model, 'u/1', 'Saturation/1');
+add_line(model, 'Saturation/1', 'y/1');
+
+simOut = sim(model, 'Solver', 'ode45', 'StopTime', '6', 'MaxStep', '0.5', ...
+    'ZeroCrossControl', 'EnableAll', 'SaveTime', 'on', 'SaveOutput', 'on', 'SaveFormat', 'Array');
+t = simOut.get('tout');
+y = simOut.get('yout');
+
+% Instants where sin(t) = 1/a or -1/a in [0, 6]
+for a = amplitudes(amplitudes > 1)
+    s = asin(1 / a);
+    crossings = [s, pi - s, pi + s, 2 * pi - s];
+    for tc = crossings(crossings < 6)
+        if min(abs(t - tc)) > 1e-6
+            error('testSaturation:missedCrossing', 'The crossing at t = %g of the sine wave of amplitude %g is not located.', tc, a);
+        end
+    end
+end
+
+expected = min(max(sin(t) * amplitudes, -1), 1);
+if max(abs(y(:) - expected(:))) > 1e-6
+    error('testSaturation:wrongOutput', 'The output differs from the saturated input.');
+end
+
+disp('testSaturation: the zero crossings are located and the outputs are correct.');
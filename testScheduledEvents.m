@@ -0,0 +1,62 @@
+function testScheduledEvents
+% TESTSCHEDULEDEVENTS Checks the events of sfunScheduledEvents
+%
+% The test builds a model with the sfunScheduledEvents block and the events
+% (time, value): (0.5, 1), (1, 2), (1, 3) and (2.5, 4). The two events at t = 1
+% must be processed in the order they were scheduled, so the output is 3 from
+% t = 1. The simulation is then stopped at t = 1.5 and restarted from its 
+% operating point: the pending event at t = 2.5 must be restored.
+%
+% TESTSCHEDULEDEVENTS is part of EasyLink Library.
+% Copyright(c) 2014 FEMTO-ST, ENSMM, UFC, CNRS.
+
+make('sfunScheduledEvents.cpp');
+
+model = 'testScheduledEvents';
+if bdIsLoaded(model)
+    close_system(model, 0);
+end
+new_system(model);
+cleanup = onCleanup(@() close_system(model, 0));
+add_block('simulink/User-Defined Functions/S-Function', [model '/Events'], ...
+    'FunctionName', 'sfunScheduledEvents', 'Parameters', '[0.5; 1; 1; 2.5], [1; 2; 3; 4]');
+add_block('simulink/Sinks/Out1', [model '/y']);
+add_line(model, 'Events/1', 'y/1');
+options = {'Solver', 'VariableStepDiscrete', 'SaveTime', 'on', 'SaveOutput', 'on', 'SaveFormat', 'Array'};
+
+% Whole simulation
+simOut = sim(model, options{:}, 'StopTime', '3');
+t = simOut.get('tout');
+y = simOut.get('yout');
+for event = [0.5 1 2.5]
+    if ~any(t == event)
+        error('testScheduledEvents:missedEvent', 'The block does not run at t = %g.', event);
+    end
+end
+checkOutputs(t, y);
+
+% Simulation restarted from its operating point at t = 1.5
+simOut = sim(model, options{:}, 'StopTime', '1.5', 'SaveFinalState', 'on', ...
+    'FinalStateName', 'operatingPoint', 'SaveOperatingPoint', 'on');
+assignin('base', 'testScheduledEventsOperatingPoint', simOut.get('operatingPoint'));
+simOut = sim(model, options{:}, 'StopTime', '3', 'LoadInitialState', 'on', ...
+    'InitialState', 'testScheduledEventsOperatingPoint');
+evalin('base', 'clear testScheduledEventsOperatingPoint');
+t = simOut.get('tout');
+y = simOut.get('yout');
+if ~any(t == 2.5)
+    error('testScheduledEvents:lostEvent', 'The pending event at t = 2.5 is not restored.');
+end
+checkOutputs(t, y);
+
+disp('testScheduledEvents: the events are processed in order and restored.');
+
+function checkOutputs(t, y)
+expected = zeros(size(t));
+expected(t >= 0.5) = 1;
+expected(t >= 1) = 3;
+expected(t >= 2.5) = 4;
+if any(y ~= expected)
+    error('testScheduledEvents:wrongOutput', 'The output at t = %g is %g instead of %g.', ...
+        t(find(y ~= expected, 1)), y(find(y ~= expected, 1)), expected(find(y ~= expected, 1)));
+end
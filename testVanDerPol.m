@@ -0,0 +1,56 @@
+function testVanDerPol
+% TESTVANDERPOL Checks the Jacobian of sfunVanDerPol computed by automatic
+% differentiation
+%
+% The test builds a model with the sfunVanDerPol block between an inport and
+% an outport. LINMOD linearizes the model with the Jacobian of the block
+% (mdlJacobian), which must be zero outside the 4x3 pattern declared by the
+% block (rows: x1', x2', y1, y2, columns: x1, x2, u) and equal to the analytic
+% Jacobian. The model is then simulated with ode15s and compared with the
+% solution of ODE15S.
+%
+% TESTVANDERPOL is part of EasyLink Library.
+% Copyright(c) 2014 FEMTO-ST, ENSMM, UFC, CNRS.
+
+make('sfunVanDerPol.cpp');
+
+mu = 1.5;
+model = 'testVanDerPol';
+if bdIsLoaded(model)
+    close_system(model, 0);
+end
+new_system(model);
+cleanup = onCleanup(@() close_system(model, 0));
+add_block('simulink/Sources/In1', [model '/u']);
+add_block('simulink/User-Defined Functions/S-Function', [model '/Van der Pol'], ...
+    'FunctionName', 'sfunVanDerPol', 'Parameters', num2str(mu, 17));
+add_block('simulink/Sinks/Out1', [model '/y']);
+add_line(model, 'u/1', 'Van der Pol/1');
+add_line(model, 'Van der Pol/1', 'y/1');
+
+pattern = logical([0 1 0; 1 1 1; 1 0 0; 0 1 0]);
+
+for point = [0.5 -1.2 0.3; 2 0 0; -1.7 0.8 -0.5]'
+    x = point(1:2);
+    u = point(3);
+    [a, b, c, d] = linmod(model, x, u);
+    jacobian = [a b; c d];
+    expected = [0 1 0; -1 - 2 * mu * x(1) * x(2), mu * (1 - x(1)^2), 1; 1 0 0; 0 1 0];
+    if any(jacobian(~pattern))
+        error('testVanDerPol:wrongPattern', 'The Jacobian at x = [%g %g] has nonzero elements outside the declared pattern.', x);
+    end
+    if max(abs(jacobian(:) - expected(:))) > 1e-12
+        error('testVanDerPol:wrongJacobian', 'The Jacobian at x = [%g %g] differs from the analytic Jacobian.', x);
+    end
+end
+
+simOut = sim(model, 'Solver', 'ode15s', 'StopTime', '10', 'RelTol', '1e-8', 'AbsTol', '1e-10', ...
+    'LoadExternalInput', 'off', 'SaveTime', 'on', 'SaveOutput', 'on', 'SaveFormat', 'Array');
+t = simOut.get('tout');
+y = simOut.get('yout');
+[~, expected] = ode15s(@(t, x) [x(2); mu * (1 - x(1)^2) * x(2) - x(1)], t, [2; 0], odeset('RelTol', 1e-10, 'AbsTol', 1e-12));
+if max(abs(y(:) - expected(:))) > 1e-3
+    error('testVanDerPol:wrongSimulation', 'The simulation differs from the solution of ode15s.');
+end
+
+disp('testVanDerPol: the Jacobian and the simulation are correct.');